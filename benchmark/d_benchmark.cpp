@@ -0,0 +1,303 @@
+/*
+
+Squirrel ImGui Debugger Hook Benchmark
+
+MIT License
+
+Copyright 2022 Jonathon Blake Wood-Brooks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Measures what attaching the debugger costs per executed script line. Each workload is run in several debugger
+// modes and the results are written to stdout as CSV so that hook regressions can be tracked between builds:
+//
+//   workload,mode,lines,runs,median_ns,ns_per_line
+//
+// No interface thread is started; the VM Manager is driven directly.
+
+#include <d_vm.h>
+
+#include <squirrel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+  struct Workload
+  {
+    const char* m_strName;
+    const char* m_strSource;
+  };
+
+  // Representative script shapes: straight-line loops, deep call chains, and many short calls
+  const Workload g_cWorkloads[]
+  {
+    { "tight_loop",
+      "local sum = 0;\n"
+      "for( local i = 0; i < 200000; ++i )\n"
+      "{\n"
+      "  sum += i;\n"
+      "}\n" },
+
+    { "deep_recursion",
+      "function Descend( n )\n"
+      "{\n"
+      "  if( n == 0 )\n"
+      "    return 0;\n"
+      "  return 1 + Descend( n - 1 );\n"
+      "}\n"
+      "for( local i = 0; i < 200; ++i )\n"
+      "{\n"
+      "  Descend( 500 );\n"
+      "}\n" },
+
+    { "small_calls",
+      "function Add( a, b )\n"
+      "{\n"
+      "  return a + b;\n"
+      "}\n"
+      "local sum = 0;\n"
+      "for( local i = 0; i < 100000; ++i )\n"
+      "{\n"
+      "  sum = Add( sum, i );\n"
+      "}\n" }
+  };
+
+  constexpr int32_t s_iNumRuns{ 7 };
+
+  uint64_t g_uiLinesExecuted{ 0 };
+
+
+  void CountLinesHook( [[maybe_unused]] HSQUIRRELVM i_pcVM, SQInteger i_eHookType,
+                       [[maybe_unused]] const SQChar* i_strFileName, [[maybe_unused]] SQInteger i_iLine,
+                       [[maybe_unused]] const SQChar* i_strFunctionName )
+  {
+    if( SQ_LINEEXECUTION == i_eHookType )
+    {
+      ++g_uiLinesExecuted;
+    }
+  }
+
+
+  void PrintFunc( [[maybe_unused]] HSQUIRRELVM i_pcVM, const SQChar* i_strFormat, ... )
+  {
+    va_list args;
+    va_start( args, i_strFormat );
+    vfprintf( stderr, i_strFormat, args );
+    va_end( args );
+  }
+
+
+  bool Compile( HSQUIRRELVM i_pcVM, const Workload& i_rcWorkload, HSQOBJECT& o_sqClosure )
+  {
+    const std::string strSource{ std::string( "benchmark/" ) + i_rcWorkload.m_strName + ".nut" };
+    if( SQ_FAILED( sq_compilebuffer( i_pcVM, i_rcWorkload.m_strSource,
+                                     static_cast<SQInteger>( strlen( i_rcWorkload.m_strSource ) ),
+                                     strSource.c_str(), SQTrue ) ) )
+    {
+      return false;
+    }
+
+    sq_getstackobj( i_pcVM, -1, &o_sqClosure );
+    sq_addref( i_pcVM, &o_sqClosure );
+    sq_poptop( i_pcVM );
+
+    return true;
+  }
+
+
+  bool Run( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqClosure )
+  {
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
+
+    sq_pushobject( i_pcVM, i_sqClosure );
+    sq_pushroottable( i_pcVM );
+    const bool bSuccess{ SQ_SUCCEEDED( sq_call( i_pcVM, 1, SQFalse, SQTrue ) ) };
+
+    sq_settop( i_pcVM, iTop );
+
+    return bSuccess;
+  }
+
+
+  uint64_t CountLines( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqClosure )
+  {
+    g_uiLinesExecuted = 0;
+
+    sq_setnativedebughook( i_pcVM, &CountLinesHook );
+    Run( i_pcVM, i_sqClosure );
+    sq_setnativedebughook( i_pcVM, nullptr );
+
+    return g_uiLinesExecuted;
+  }
+
+
+  void Measure( HSQUIRRELVM i_pcVM, const Workload& i_rcWorkload, HSQOBJECT i_sqClosure, uint64_t i_uiLines,
+                const char* i_strMode )
+  {
+    std::vector<int64_t> vDurations;
+    vDurations.reserve( s_iNumRuns );
+
+    for( int32_t i{ 0 }; i < s_iNumRuns; ++i )
+    {
+      const auto tStart{ std::chrono::steady_clock::now() };
+      Run( i_pcVM, i_sqClosure );
+      const auto tEnd{ std::chrono::steady_clock::now() };
+
+      vDurations.push_back( std::chrono::duration_cast<std::chrono::nanoseconds>( tEnd - tStart ).count() );
+    }
+
+    std::sort( vDurations.begin(), vDurations.end() );
+    const int64_t iMedian{ vDurations[vDurations.size() / 2] };
+
+    printf( "%s,%s,%llu,%d,%lld,%.3f\n", i_rcWorkload.m_strName, i_strMode,
+            static_cast<unsigned long long>( i_uiLines ), s_iNumRuns, static_cast<long long>( iMedian ),
+            i_uiLines ? static_cast<double>( iMedian ) / static_cast<double>( i_uiLines ) : 0.0 );
+  }
+
+
+  void AddBreakpoints( std::vector<rumDebugBreakpoint>& io_vBreakpoints, size_t i_szCount )
+  {
+    // Breakpoints are spread across files that never execute, so they are checked but never hit
+    while( io_vBreakpoints.size() < i_szCount )
+    {
+      const size_t szIndex{ io_vBreakpoints.size() };
+      const std::string strFile{ "benchmark/other_" + std::to_string( szIndex % 50 ) + ".nut" };
+
+      rumDebugBreakpoint cBreakpoint( strFile, static_cast<uint32_t>( szIndex + 1 ) );
+      rumDebugVM::BreakpointAdd( cBreakpoint );
+      io_vBreakpoints.push_back( cBreakpoint );
+    }
+  }
+
+
+  void RemoveBreakpoints( std::vector<rumDebugBreakpoint>& io_vBreakpoints )
+  {
+    for( const auto& iter : io_vBreakpoints )
+    {
+      rumDebugVM::BreakpointRemove( iter );
+    }
+
+    io_vBreakpoints.clear();
+  }
+} // namespace
+
+
+int main()
+{
+  HSQUIRRELVM pcVM{ sq_open( 1024 ) };
+  sq_setprintfunc( pcVM, &PrintFunc, &PrintFunc );
+
+  // Line events only exist for scripts compiled with debug info
+  rumDebugVM::EnableDebugInfo( pcVM );
+
+  std::vector<HSQOBJECT> vClosures;
+  std::vector<uint64_t> vLines;
+
+  for( const auto& iter : g_cWorkloads )
+  {
+    HSQOBJECT sqClosure;
+    if( !Compile( pcVM, iter, sqClosure ) )
+    {
+      fprintf( stderr, "Failed to compile workload %s\n", iter.m_strName );
+      return 1;
+    }
+
+    vClosures.push_back( sqClosure );
+    vLines.push_back( CountLines( pcVM, sqClosure ) );
+  }
+
+  const auto RunAll{ [&]( const char* i_strMode )
+  {
+    for( size_t i{ 0 }; i < vClosures.size(); ++i )
+    {
+      Measure( pcVM, g_cWorkloads[i], vClosures[i], vLines[i], i_strMode );
+    }
+  } };
+
+  printf( "workload,mode,lines,runs,median_ns,ns_per_line\n" );
+
+  RunAll( "not_attached" );
+
+  rumDebugVM::RegisterVM( pcVM, "Benchmark" );
+  rumDebugVM::Update();
+
+  RunAll( "attached_no_breakpoints" );
+
+  rumDebugVM::LineProfilerStart( "Benchmark" );
+  RunAll( "line_profiler" );
+  rumDebugVM::LineProfilerStop( "Benchmark" );
+  rumDebugVM::Update();
+
+  rumDebugVM::FunctionProfilerStart( "Benchmark" );
+  RunAll( "function_profiler" );
+  rumDebugVM::FunctionProfilerStop( "Benchmark" );
+  rumDebugVM::Update();
+
+  rumDebugVM::SamplerStart( "Benchmark" );
+  RunAll( "sampler" );
+  rumDebugVM::SamplerStop( "Benchmark" );
+  rumDebugVM::Update();
+
+  rumDebugVM::CoverageStart( "Benchmark" );
+  RunAll( "line_coverage" );
+  rumDebugVM::CoverageStop( "Benchmark" );
+  rumDebugVM::Update();
+
+  std::vector<rumDebugBreakpoint> vBreakpoints;
+  for( size_t szCount : { 10U, 100U, 1000U } )
+  {
+    AddBreakpoints( vBreakpoints, szCount );
+
+    const std::string strMode{ "attached_" + std::to_string( szCount ) + "_breakpoints" };
+    RunAll( strMode.c_str() );
+  }
+
+  RemoveBreakpoints( vBreakpoints );
+  rumDebugVM::Update();
+
+  // Stepping over from outside of any script call never completes during a run, so every line is checked against
+  // the step directive for the whole workload
+  rumDebugVM::RequestStepOver();
+  RunAll( "step_over" );
+  rumDebugVM::RequestResume();
+  rumDebugVM::Update();
+
+  rumDebugVM::DetachVM( pcVM );
+  rumDebugVM::Shutdown();
+
+  for( auto& iter : vClosures )
+  {
+    sq_release( pcVM, &iter );
+  }
+
+  sq_close( pcVM );
+
+  return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <squirrel.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Represents a watch such as "world.entities[42].stats.hp" or "this.inventory["sword"]" parsed into the lookups that
+// resolve it: a root name followed by a chain of member and index keys. Paths are parsed once, and their names and keys
+// are interned as objects of the VM they are first resolved on, so resolving one on each pause is only a lookup of its
+// root and an sq_get per key.
+
+struct rumDebugAccessPath
+{
+  // A member name or string index, or an integer index
+  struct Key
+  {
+    std::string m_strKey;
+    int64_t m_iKey{ 0 };
+    bool m_bInteger{ false };
+
+    // The key as an object of m_pcVM
+    HSQOBJECT m_sqKey;
+  };
+
+  // The name the path starts from. It is looked up as a local of the frame, then in the root and const tables, and
+  // then as a member of this.
+  std::string m_strRoot;
+
+  std::vector<Key> m_vKeys;
+
+  // The VM the root name and keys are interned in and referenced by, or null if they haven't been interned. The
+  // references must be released on that VM's thread, so a path is never released when it is destroyed.
+  HSQUIRRELVM m_pcVM{ nullptr };
+  HSQOBJECT m_sqRoot;
+
+  // The index of the local the root was last found at, which is checked before searching the frame's other locals
+  int32_t m_iLocalIndex{ -1 };
+
+  // Set when the path is prefixed with "::", so that its root is only looked up in the root table
+  bool m_bRootTable{ false };
+
+  // Cleared if the source is not an access path
+  bool m_bValid{ false };
+};
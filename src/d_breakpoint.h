@@ -1,6 +1,13 @@
 #pragma once
 
+#include <squirrel.h>
+
+#include <atomic>
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 // Represents a script breakpoint set by the user
 
@@ -23,6 +30,207 @@ struct rumDebugBreakpoint
   }
 
   std::filesystem::path m_fsFilepath;
+
+  // An optional script expression. When set, the breakpoint only stops execution when the expression is truthy.
+  std::string m_strCondition;
+
+  // An optional message template. When set, the breakpoint is a logpoint that logs the message each time it is hit
+  // instead of stopping execution. Script expressions in braces are evaluated and substituted, e.g. "hp={hp}".
+  std::string m_strLogMessage;
+
+  // The last error reported while compiling or evaluating the condition or log message
+  std::string m_strError;
+
   uint32_t m_uiLine{ 0 };
   bool m_bEnabled{ true };
 };
+
+
+// Represents a breakpoint on calls to a script function by name, optionally qualified by class as "Class::Function"
+
+struct rumDebugFunctionBreakpoint
+{
+  rumDebugFunctionBreakpoint() = default;
+
+  rumDebugFunctionBreakpoint( const std::string& i_strQualifiedName, bool i_bEnabled = true )
+    : m_bEnabled( i_bEnabled )
+  {
+    // Accept either "Class::Function" or "Class.Function"
+    size_t szSeparator{ i_strQualifiedName.rfind( "::" ) };
+    size_t szSeparatorLength{ 2 };
+    if( std::string::npos == szSeparator )
+    {
+      szSeparator = i_strQualifiedName.rfind( '.' );
+      szSeparatorLength = 1;
+    }
+
+    if( std::string::npos == szSeparator )
+    {
+      m_strFunction = i_strQualifiedName;
+    }
+    else
+    {
+      m_strClass = i_strQualifiedName.substr( 0, szSeparator );
+      m_strFunction = i_strQualifiedName.substr( szSeparator + szSeparatorLength );
+    }
+  }
+
+  bool operator==( const rumDebugFunctionBreakpoint& i_rcBreakpoint ) const
+  {
+    return( m_strFunction.compare( i_rcBreakpoint.m_strFunction ) == 0 &&
+            m_strClass.compare( i_rcBreakpoint.m_strClass ) == 0 );
+  }
+
+  std::string GetQualifiedName() const
+  {
+    return m_strClass.empty() ? m_strFunction : m_strClass + "::" + m_strFunction;
+  }
+
+  // The class name as it is found in the root table, or empty to match the function in any class or none
+  std::string m_strClass;
+  std::string m_strFunction;
+
+  // The number of matching calls so far. Copies share the counter so that it survives breakpoint index rebuilds.
+  std::shared_ptr<std::atomic<uint32_t>> m_pcNumHits{ std::make_shared<std::atomic<uint32_t>>( 0 ) };
+
+  // Only stop on the call that brings the number of hits to this value, or on every call if zero
+  uint32_t m_uiHitCount{ 0 };
+
+  bool m_bEnabled{ true };
+};
+
+
+// A compiled lookup of all enabled breakpoints, indexed by interned file id and then by a per-file line bitset so
+// that the debug hook can test a line without touching paths or iterating the breakpoint list. Function breakpoints
+// are indexed by function name and are only checked on calls.
+
+struct rumDebugBreakpointIndex
+{
+  void Add( uint32_t i_uiFileID, const rumDebugBreakpoint& i_rcBreakpoint )
+  {
+    if( i_uiFileID >= m_vFileLines.size() )
+    {
+      m_vFileLines.resize( i_uiFileID + 1 );
+    }
+
+    const uint32_t uiLine{ i_rcBreakpoint.m_uiLine };
+
+    auto& rcvLines{ m_vFileLines[i_uiFileID] };
+    const size_t szWord{ uiLine >> 6 };
+    if( szWord >= rcvLines.size() )
+    {
+      rcvLines.resize( szWord + 1, 0 );
+    }
+
+    rcvLines[szWord] |= uint64_t{ 1 } << ( uiLine & 63 );
+    ++m_szNumBreakpoints;
+
+    if( !i_rcBreakpoint.m_strCondition.empty() || !i_rcBreakpoint.m_strLogMessage.empty() )
+    {
+      m_mapDetailedBreakpoints.insert_or_assign( MakeKey( i_uiFileID, uiLine ), i_rcBreakpoint );
+    }
+  }
+
+  void AddFunction( const rumDebugFunctionBreakpoint& i_rcBreakpoint )
+  {
+    m_mapFunctionBreakpoints[i_rcBreakpoint.m_strFunction].push_back( i_rcBreakpoint );
+  }
+
+  void Clear()
+  {
+    m_mapFunctionBreakpoints.clear();
+    m_vFileLines.clear();
+    m_mapDetailedBreakpoints.clear();
+    m_szNumBreakpoints = 0;
+  }
+
+  // Returns the breakpoint at the file and line if it has a condition or log message, otherwise it is a plain
+  // breakpoint that always stops execution
+  const rumDebugBreakpoint* FindDetailedBreakpoint( uint32_t i_uiFileID, uint32_t i_uiLine ) const
+  {
+    if( m_mapDetailedBreakpoints.empty() )
+    {
+      return nullptr;
+    }
+
+    const auto& iter{ m_mapDetailedBreakpoints.find( MakeKey( i_uiFileID, i_uiLine ) ) };
+    return iter != m_mapDetailedBreakpoints.end() ? &iter->second : nullptr;
+  }
+
+  // Returns all function breakpoints on functions with the specified name, or null if there are none
+  const std::vector<rumDebugFunctionBreakpoint>* FindFunctionBreakpoints( const SQChar* i_strFunction ) const
+  {
+    const auto& iter{ m_mapFunctionBreakpoints.find( i_strFunction ) };
+    return iter != m_mapFunctionBreakpoints.end() ? &iter->second : nullptr;
+  }
+
+  bool HasBreakpoint( uint32_t i_uiFileID, uint32_t i_uiLine ) const
+  {
+    if( i_uiFileID >= m_vFileLines.size() )
+    {
+      return false;
+    }
+
+    const auto& rcvLines{ m_vFileLines[i_uiFileID] };
+    const size_t szWord{ i_uiLine >> 6 };
+    return( szWord < rcvLines.size() && ( ( rcvLines[szWord] >> ( i_uiLine & 63 ) ) & 1 ) );
+  }
+
+  // Returns true if there is a breakpoint at or after the specified line in the file
+  bool HasBreakpointFrom( uint32_t i_uiFileID, uint32_t i_uiLine ) const
+  {
+    if( i_uiFileID >= m_vFileLines.size() )
+    {
+      return false;
+    }
+
+    const auto& rcvLines{ m_vFileLines[i_uiFileID] };
+    size_t szWord{ i_uiLine >> 6 };
+    if( szWord >= rcvLines.size() )
+    {
+      return false;
+    }
+
+    if( rcvLines[szWord] >> ( i_uiLine & 63 ) )
+    {
+      return true;
+    }
+
+    while( ++szWord < rcvLines.size() )
+    {
+      if( rcvLines[szWord] )
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool HasFunctionBreakpoints() const
+  {
+    return !m_mapFunctionBreakpoints.empty();
+  }
+
+  // Returns true if there are no line breakpoints
+  bool IsEmpty() const
+  {
+    return 0 == m_szNumBreakpoints;
+  }
+
+  static uint64_t MakeKey( uint32_t i_uiFileID, uint32_t i_uiLine )
+  {
+    return ( static_cast<uint64_t>( i_uiFileID ) << 32 ) | i_uiLine;
+  }
+
+  // One line bitset per interned file id, empty for files without enabled breakpoints
+  std::vector<std::vector<uint64_t>> m_vFileLines;
+
+  // Enabled function breakpoints keyed by unqualified function name
+  std::unordered_map<std::string, std::vector<rumDebugFunctionBreakpoint>> m_mapFunctionBreakpoints;
+
+  // Copies of the enabled breakpoints that have conditions or log messages, keyed by file id and line
+  std::unordered_map<uint64_t, rumDebugBreakpoint> m_mapDetailedBreakpoints;
+
+  size_t m_szNumBreakpoints{ 0 };
+};
@@ -1,9 +1,20 @@
 #pragma once
 
+#include <d_accesspath.h>
+#include <d_breakpoint.h>
+#include <d_expression.h>
+#include <d_profiler.h>
+#include <d_stats.h>
+
 #include <squirrel.h>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <memory>
 #include <queue>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 using HSQUIRRELCONSTVM = SQVM const*;
@@ -35,6 +46,72 @@ struct rumDebugContext
     std::string m_strFunction;
   };
 
+  struct SourceFileID
+  {
+    std::string m_strSource;
+    uint32_t m_uiFileID{ 0 };
+  };
+
+  struct FunctionNameBreakpoints
+  {
+    // The function name, used to detect a recycled name pointer
+    std::string m_strName;
+
+    // The function breakpoints on this name in the breakpoint index of m_uiGeneration, or null if there are none
+    const std::vector<rumDebugFunctionBreakpoint>* m_pcvBreakpoints{ nullptr };
+
+    // The method closure of each class-qualified breakpoint, parallel to the breakpoints. Each is fetched from its
+    // class the first time it is checked, referenced until the next breakpoint generation, and null until its class
+    // exists.
+    std::vector<HSQOBJECT> m_vMethods;
+
+    uint32_t m_uiGeneration{ 0 };
+    bool m_bResolved{ false };
+  };
+
+  struct LogMessage
+  {
+    // The logpoint's message template, and the expression it was converted into
+    std::string m_strTemplate;
+    rumDebugExpression m_cExpression;
+  };
+
+  struct FunctionBreakpoints
+  {
+    // The function's source name pointer and first line, used to detect a recycled prototype address
+    const SQChar* m_strSource{ nullptr };
+    SQInteger m_iLine{ 0 };
+
+    // The breakpoint generation the flag was computed for
+    uint32_t m_uiGeneration{ 0 };
+
+    bool m_bHasBreakpoints{ true };
+  };
+
+  struct ProfileFunctionID
+  {
+    // The function's source and name pointers, used to detect a recycled prototype address
+    const SQChar* m_strSource{ nullptr };
+    const SQChar* m_strFunction{ nullptr };
+
+    uint32_t m_uiFunction{ 0 };
+    bool m_bResolved{ false };
+  };
+
+  struct ProfileFrame
+  {
+    // The call tree node of the executing call
+    uint32_t m_uiNode{ 0 };
+
+    // The call depth the frame was entered at
+    int32_t m_iCallDepth{ 0 };
+
+    std::chrono::steady_clock::time_point m_tStart;
+
+    // Time spent in calls made from this frame so far
+    int64_t m_iChildNS{ 0 };
+  };
+
   // A pointer to the VM
   HSQUIRRELVM m_pcVM{ nullptr };
 
@@ -44,6 +121,102 @@ struct rumDebugContext
   // The last known callstack
   std::vector<CallstackEntry> m_vCallstack;
 
+  // Interned file ids keyed by the source name pointers Squirrel hands to the debug hook. The source string is kept so
+  // that a pointer recycled for a different source name is detected.
+  std::unordered_map<const SQChar*, SourceFileID> m_mapSourceFileIDs;
+
+  // The source name pointer and file id of the most recent debug hook event
+  const SQChar* m_strLastSource{ nullptr };
+  uint32_t m_uiLastFileID{ 0 };
+
+  // The breakpoint index this VM is currently checking against and the generation it was published as. Only the VM's
+  // own thread touches these.
+  std::shared_ptr<const rumDebugBreakpointIndex> m_pcBreakpointIndex;
+  uint32_t m_uiBreakpointGeneration{ 0 };
+
+  // Whether or not any enabled breakpoint can fall within a function, keyed by function prototype
+  std::unordered_map<SQUserPointer, FunctionBreakpoints> m_mapFunctionBreakpoints;
+
+  // Whether or not the executing function can contain an enabled breakpoint. This is only trusted while valid and
+  // computed for the current breakpoint generation.
+  uint32_t m_uiFunctionBreakpointsGeneration{ 0 };
+  bool m_bFunctionHasBreakpoints{ true };
+  bool m_bFunctionBreakpointsValid{ false };
+
+  // Compiled breakpoint conditions keyed by breakpoint file id and line. Conditions are compiled into closures owned
+  // by this VM the first time their line is hit, and are released when the VM is detached.
+  std::unordered_map<uint64_t, rumDebugExpression> m_mapBreakpointConditions;
+
+  // Compiled logpoint messages keyed by breakpoint file id and line, managed the same way as conditions
+  std::unordered_map<uint64_t, LogMessage> m_mapLogMessages;
+
+  // Compiled watch expressions keyed by expression text, managed the same way as conditions. They are compiled the
+  // first time this VM pauses with the watch set, and are only run again on later pauses.
+  std::unordered_map<std::string, rumDebugExpression> m_mapWatchExpressions;
+
+  // Watch expressions edited or removed since this VM last built its watches. Their closures are released, and their
+  // failures forgotten, on the VM's thread before its watches are next built.
+  std::vector<std::string> m_vEvictedWatchExpressions;
+
+  // Access paths of watches that were edited or removed, or moved on to another VM, while they held names interned in
+  // this VM. They are released the same way as evicted watch expressions.
+  std::vector<std::shared_ptr<rumDebugAccessPath>> m_vEvictedAccessPaths;
+
+  // Function breakpoints keyed by the name pointers Squirrel hands to the debug hook on calls. Squirrel interns its
+  // strings, so each function name resolves once per breakpoint generation rather than once per call.
+  std::unordered_map<const SQChar*, FunctionNameBreakpoints> m_mapFunctionNameBreakpoints;
+
+  // Executed line counts, recorded while line profiling
+  rumDebugLineCounts m_cLineCounts;
+
+  // Executed lines, recorded while collecting coverage
+  rumDebugLineCoverage m_cLineCoverage;
+
+  // Call timings gathered by the function profiler. Only the VM's own thread touches the tree, the lookups used to
+  // build it, and the shadow call stack. Nothing is allocated per call once a call path and function have been seen.
+  rumDebugCallTree m_cCallTree;
+
+  // Call tree nodes keyed by parent node and function id
+  std::unordered_map<uint64_t, uint32_t> m_mapCallTreeNodes;
+
+  // Every function the profilers have seen, indexed by function id
+  rumDebugProfileFunctions m_cProfileFunctions;
+
+  // Profiler function ids keyed by function prototype, and by source, line, and name so that a reloaded function
+  // shares the id of the function it replaced. Only the VM's own thread touches these.
+  std::unordered_map<SQUserPointer, ProfileFunctionID> m_mapProfileFunctionIDs;
+  std::unordered_map<std::string, uint32_t> m_mapProfileFunctionNames;
+
+  // The calls currently executing, innermost last
+  std::vector<ProfileFrame> m_vProfileStack;
+
+  // The call tree most recently copied for display, including the time spent so far in calls still executing. Load
+  // and store with the std::atomic_ free functions.
+  std::shared_ptr<const rumDebugCallTree> m_pcCallTreeSnapshot;
+  std::chrono::steady_clock::time_point m_tCallTreeSnapshot;
+
+  // Samples captured on the VM's thread awaiting the sampler thread, allocated the first time the VM is sampled
+  std::unique_ptr<rumDebugSampleBuffer> m_pcSampleBuffer;
+
+  // Set by the sampler thread when the next executed line should be sampled
+  std::atomic<bool> m_bSampleRequested{ false };
+
+  // Samples aggregated by the sampler thread, in the same forms as the instrumented line counts and call tree. These
+  // are only touched while holding the sampler lock.
+  rumDebugLineCounts m_cSampledLineCounts;
+  rumDebugCallTree m_cSampledCallTree;
+  std::unordered_map<uint64_t, uint32_t> m_mapSampledCallTreeNodes;
+
+  // The sampled call tree most recently copied for display. Load and store with the std::atomic_ free functions.
+  std::shared_ptr<const rumDebugCallTree> m_pcSampledCallTreeSnapshot;
+  std::chrono::steady_clock::time_point m_tSampledCallTreeSnapshot;
+
+  // Call, return, sample, and pause events awaiting the export writer, allocated the first time the VM is traced
+  std::unique_ptr<rumDebugTraceBuffer> m_pcTraceBuffer;
+
+  // The debugger's own overhead in this VM
+  rumDebugHookStats m_cHookStats;
+
   // The current file the VM is paused on
   std::filesystem::path m_fsPausedFile;
 
@@ -53,18 +226,62 @@ struct rumDebugContext
   // The current line the VM is paused at
   uint32_t m_uiPausedLine{ 0 };
 
-  // The last known stack level when a step directive was issued
-  uint32_t m_uiStepDirectiveStackLevel{ 0 };
+  // The number of script frames on the stack, tracked from call and return events so that it never has to be walked
+  int32_t m_iCallDepth{ 0 };
+
+  // The call depth when a step directive was issued
+  int32_t m_iStepDirectiveCallDepth{ 0 };
 
   // Whether or not the context is attached or detached
   bool m_bAttached{ false };
 
+  // Set when the call depth can no longer be trusted, such as after attaching mid-execution, so that the next hook
+  // event recounts it from the stack
+  bool m_bResyncCallDepth{ true };
+
+  // Whether or not the native debug hook is currently installed on the VM
+  bool m_bHookInstalled{ false };
+
+  // Set while the debug hook is suspended in SuspendVM. Squirrel re-enables its hook flag when a hook returns, so the
+  // hook must not be removed while this is set.
+  bool m_bInDebugHook{ false };
+
+  // Whether or not executed lines are being counted
+  bool m_bLineProfiling{ false };
+
+  // Whether or not executed lines are being marked as covered
+  bool m_bLineCoverage{ false };
+
+  // Whether or not calls are being timed
+  bool m_bFunctionProfiling{ false };
+
+  // Set when the call tree has changed since it was last copied for display
+  bool m_bCallTreeChanged{ false };
+
+  // Should the call tree be cleared on the next update?
+  bool m_bCallTreeResetRequested{ false };
+
+  // Whether or not the sampler thread is sampling the VM
+  bool m_bSampling{ false };
+
+  // Set when the sampled call tree has changed since it was last copied for display
+  bool m_bSampledCallTreeChanged{ false };
+
+  // Whether or not the VM's events are being recorded to a trace
+  bool m_bTracing{ false };
+
   // Whether or not the VM is paused
   bool m_bPaused{ false };
 
+  // Should the VM pause on the next executed line?
+  bool m_bPauseRequested{ false };
+
   // Should the update focus on the paused instruction pointer?
   bool m_bFocusOnCurrentInstruction{ false };
 
   // Has there been a variable request or stack level change?
   bool m_bUpdateVariables{ false };
+
+  // Has the interface requested the children or description of an expanded variable?
+  bool m_bFetchVariables{ false };
 };
@@ -0,0 +1,786 @@
+/*
+
+Squirrel ImGui Debugger Export
+
+MIT License
+
+Copyright 2022 Jonathon Blake Wood-Brooks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <d_export.h>
+
+#include <d_settings.h>
+#include <d_utility.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace rumDebugExport
+{
+  // A VM whose events are being traced, and the writer's state for it
+  struct TracedVM
+  {
+    rumDebugContext* m_pcContext{ nullptr };
+
+    // The VM's functions, copied as new function ids appear in its events
+    std::vector<rumDebugProfileFunction> m_vFunctions;
+
+    // The trace thread id the VM's events are shown under
+    uint32_t m_uiThreadID{ 0 };
+
+    // The call depths of the calls begun during the trace that haven't returned yet, innermost last
+    std::vector<int32_t> m_viOpenCallDepths;
+  };
+
+  // An export waiting to be written. The write function returns false on failure.
+  struct QueuedExport
+  {
+    std::filesystem::path m_fsFilePath;
+    std::function<bool( const std::filesystem::path& )> m_fnWrite;
+  };
+
+  // Guards all of the state below
+  std::mutex g_mtxExportLock;
+
+  // Wakes the writer thread early when there is new work or the trace has stopped
+  std::condition_variable g_cvExport;
+
+  std::thread g_cWriterThread;
+
+  // Set by the writer thread as it exits for lack of work, so that it can be joined
+  bool g_bWriterDone{ false };
+
+  std::deque<QueuedExport> g_qExports;
+
+  std::vector<TracedVM> g_vTracedVMs;
+
+  // The trace file, and the part of it not yet written to the file
+  std::ofstream g_cTraceFile;
+  std::string g_strTraceChunk;
+
+  // Trace timestamps are relative to the start of the trace
+  int64_t g_iTraceStartNS{ 0 };
+
+  uint32_t g_uiNextTraceThreadID{ 1 };
+
+  bool g_bTracing{ false };
+
+  // Every trace event after the first is preceded by a separator
+  bool g_bTraceHasEvents{ false };
+
+  std::string g_strLastError;
+
+
+  ///////////////
+  // Prototypes
+  ///////////////
+
+  // Appends a function's name, source file, and line as a collapsed stack frame
+  void AppendFrameName( std::string& io_strOut, const rumDebugProfileFunction& i_rcFunction );
+
+  // Appends the value as a quoted and escaped JSON string
+  void AppendJSONString( std::string& io_strOut, std::string_view i_strValue );
+
+  // Appends the opening fields common to every trace event
+  void BeginTraceEvent( char i_cPhase, uint32_t i_uiThreadID );
+  void BeginTraceEvent( char i_cPhase, uint32_t i_uiThreadID, int64_t i_iTimeNS );
+
+  void DrainTraceEvents( TracedVM& io_rcTracedVM );
+
+  // Ends the VM's calls that haven't returned, so that every call in the trace is closed
+  void EndOpenCalls( TracedVM& io_rcTracedVM, int64_t i_iTimeNS );
+
+  // Adds the export to the queue and wakes the writer thread
+  void EnqueueExport( QueuedExport&& i_rcExport );
+
+  // Writes the chunk to the file once it reaches the chunk size, or regardless if forced
+  void FlushChunk( std::ofstream& io_rcFile, std::string& io_strChunk, bool i_bForce );
+
+  // Writes the trace chunk to the file once it reaches the chunk size, or regardless if forced
+  void FlushTraceChunk( bool i_bForce );
+
+  const rumDebugProfileFunction& GetFunction( TracedVM& io_rcTracedVM, uint32_t i_uiFunction );
+
+  // Starts the writer thread, unless it's running. Must be called with the export lock held.
+  void StartWriterThread();
+
+  bool WriteCollapsedStacks( const rumDebugCallTree& i_rcCallTree, rumDebugProfileSource i_eSource,
+                             const std::filesystem::path& i_fsFilePath );
+  bool WriteLineCoverage( const std::vector<CoveredFile>& i_vCoveredFiles, const std::filesystem::path& i_fsFilePath );
+  void WriteTraceEvent( TracedVM& io_rcTracedVM, const rumDebugTraceEvent& i_rcEvent );
+
+  // Writes queued exports and collects trace events until there is nothing left to do
+  void WriterThread();
+
+
+  void AppendFrameName( std::string& io_strOut, const rumDebugProfileFunction& i_rcFunction )
+  {
+    const size_t szStart{ io_strOut.size() };
+
+    io_strOut += i_rcFunction.m_strFunction.empty() ? "(anonymous)" : i_rcFunction.m_strFunction;
+    io_strOut += " (";
+    io_strOut += std::filesystem::path( i_rcFunction.m_strSource ).filename().generic_string();
+    io_strOut += ':';
+    io_strOut += std::to_string( i_rcFunction.m_iLine );
+    io_strOut += ')';
+
+    // Semicolons separate frames and newlines separate stacks, so neither can appear in a frame
+    std::replace_if( io_strOut.begin() + szStart, io_strOut.end(),
+                     []( char i_cChar ) { return ';' == i_cChar || '\n' == i_cChar || '\r' == i_cChar; }, '_' );
+  }
+
+
+  void AppendJSONString( std::string& io_strOut, std::string_view i_strValue )
+  {
+    io_strOut += '"';
+
+    for( const char cChar : i_strValue )
+    {
+      switch( cChar )
+      {
+        case '"':  io_strOut += "\\\""; break;
+        case '\\': io_strOut += "\\\\"; break;
+        case '\n': io_strOut += "\\n"; break;
+        case '\r': io_strOut += "\\r"; break;
+        case '\t': io_strOut += "\\t"; break;
+        default:
+          if( static_cast<unsigned char>( cChar ) < 0x20 )
+          {
+            char strEscape[8];
+            snprintf( strEscape, sizeof( strEscape ), "\\u%04x", static_cast<uint32_t>( cChar ) );
+            io_strOut += strEscape;
+          }
+          else
+          {
+            io_strOut += cChar;
+          }
+          break;
+      }
+    }
+
+    io_strOut += '"';
+  }
+
+
+  void BeginTraceEvent( char i_cPhase, uint32_t i_uiThreadID )
+  {
+    g_strTraceChunk += g_bTraceHasEvents ? ",\n" : "\n";
+    g_bTraceHasEvents = true;
+
+    g_strTraceChunk += "{\"ph\":\"";
+    g_strTraceChunk += i_cPhase;
+    g_strTraceChunk += "\",\"pid\":1,\"tid\":";
+    g_strTraceChunk += std::to_string( i_uiThreadID );
+  }
+
+
+  void BeginTraceEvent( char i_cPhase, uint32_t i_uiThreadID, int64_t i_iTimeNS )
+  {
+    BeginTraceEvent( i_cPhase, i_uiThreadID );
+
+    // Timestamps are in microseconds
+    char strTime[32];
+    snprintf( strTime, sizeof( strTime ), ",\"ts\":%.3f",
+              std::max<int64_t>( i_iTimeNS - g_iTraceStartNS, 0 ) / 1.0e3 );
+    g_strTraceChunk += strTime;
+  }
+
+
+  void DrainTraceEvents( TracedVM& io_rcTracedVM )
+  {
+    io_rcTracedVM.m_pcContext->m_pcTraceBuffer->Drain( [&io_rcTracedVM]( const rumDebugTraceEvent& i_rcEvent )
+    {
+      WriteTraceEvent( io_rcTracedVM, i_rcEvent );
+    } );
+  }
+
+
+  void EndOpenCalls( TracedVM& io_rcTracedVM, int64_t i_iTimeNS )
+  {
+    for( ; !io_rcTracedVM.m_viOpenCallDepths.empty(); io_rcTracedVM.m_viOpenCallDepths.pop_back() )
+    {
+      BeginTraceEvent( 'E', io_rcTracedVM.m_uiThreadID, i_iTimeNS );
+      g_strTraceChunk += '}';
+    }
+  }
+
+
+  void EnqueueExport( QueuedExport&& i_rcExport )
+  {
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+      g_qExports.push_back( std::move( i_rcExport ) );
+      StartWriterThread();
+    }
+
+    g_cvExport.notify_all();
+  }
+
+
+  void ExportCollapsedStacks( std::shared_ptr<const rumDebugCallTree> i_pcCallTree, rumDebugProfileSource i_eSource,
+                              const std::filesystem::path& i_fsFilePath )
+  {
+    if( !i_pcCallTree )
+    {
+      return;
+    }
+
+    EnqueueExport( { i_fsFilePath, [pcCallTree = std::move( i_pcCallTree ), i_eSource]( const auto& i_rfsFilePath )
+    {
+      return WriteCollapsedStacks( *pcCallTree, i_eSource, i_rfsFilePath );
+    } } );
+  }
+
+
+  void ExportLineCoverage( std::vector<CoveredFile> i_vCoveredFiles, const std::filesystem::path& i_fsFilePath )
+  {
+    // Shared so that the write function stays copyable
+    auto pcCoveredFiles{ std::make_shared<const std::vector<CoveredFile>>( std::move( i_vCoveredFiles ) ) };
+
+    EnqueueExport( { i_fsFilePath, [pcCoveredFiles]( const auto& i_rfsFilePath )
+    {
+      return WriteLineCoverage( *pcCoveredFiles, i_rfsFilePath );
+    } } );
+  }
+
+
+  void FlushChunk( std::ofstream& io_rcFile, std::string& io_strChunk, bool i_bForce )
+  {
+    if( !io_strChunk.empty() && ( i_bForce || io_strChunk.size() >= EXPORT_CHUNK_BYTES ) )
+    {
+      io_rcFile.write( io_strChunk.data(), static_cast<std::streamsize>( io_strChunk.size() ) );
+      io_strChunk.clear();
+    }
+  }
+
+
+  void FlushTraceChunk( bool i_bForce )
+  {
+    FlushChunk( g_cTraceFile, g_strTraceChunk, i_bForce );
+
+    if( !g_cTraceFile.good() && g_strLastError.empty() )
+    {
+      g_strLastError = "Failed to write the trace file";
+    }
+  }
+
+
+  const rumDebugProfileFunction& GetFunction( TracedVM& io_rcTracedVM, uint32_t i_uiFunction )
+  {
+    if( i_uiFunction >= io_rcTracedVM.m_vFunctions.size() )
+    {
+      // A function first seen since the last lookup
+      io_rcTracedVM.m_pcContext->m_cProfileFunctions.CopyTo( io_rcTracedVM.m_vFunctions );
+    }
+
+    static const rumDebugProfileFunction s_cUnknownFunction{ "", "(unknown)", 0 };
+    return i_uiFunction < io_rcTracedVM.m_vFunctions.size() ? io_rcTracedVM.m_vFunctions[i_uiFunction]
+                                                             : s_cUnknownFunction;
+  }
+
+
+  std::string GetLastError()
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+    return g_strLastError;
+  }
+
+
+  bool IsTracing()
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+    return g_bTracing;
+  }
+
+
+  void Shutdown()
+  {
+    TraceStop();
+
+    std::thread cWriterThread;
+
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+      cWriterThread = std::move( g_cWriterThread );
+    }
+
+    // The writer thread exits once it has written the queued exports
+    if( cWriterThread.joinable() )
+    {
+      g_cvExport.notify_all();
+      cWriterThread.join();
+    }
+  }
+
+
+  void StartWriterThread()
+  {
+    if( g_cWriterThread.joinable() )
+    {
+      if( !g_bWriterDone )
+      {
+        // Still running, so it will find the new work
+        return;
+      }
+
+      g_cWriterThread.join();
+    }
+
+    g_bWriterDone = false;
+    g_cWriterThread = std::thread( WriterThread );
+  }
+
+
+  void TraceAddVM( rumDebugContext& io_rcContext )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+    if( !g_bTracing || !io_rcContext.m_pcTraceBuffer )
+    {
+      return;
+    }
+
+    const auto& iter{ std::find_if( g_vTracedVMs.begin(), g_vTracedVMs.end(), [&io_rcContext]( const auto& i_rcVM )
+    {
+      return i_rcVM.m_pcContext == &io_rcContext;
+    } ) };
+
+    if( iter != g_vTracedVMs.end() )
+    {
+      return;
+    }
+
+    // Discard events recorded after an earlier trace finished with the VM
+    io_rcContext.m_pcTraceBuffer->Drain( []( const rumDebugTraceEvent& ) {} );
+
+    TracedVM cTracedVM;
+    cTracedVM.m_pcContext = &io_rcContext;
+    cTracedVM.m_uiThreadID = g_uiNextTraceThreadID++;
+
+    // Name the VM's thread in trace viewers
+    BeginTraceEvent( 'M', cTracedVM.m_uiThreadID );
+    g_strTraceChunk += ",\"name\":\"thread_name\",\"args\":{\"name\":";
+    AppendJSONString( g_strTraceChunk, io_rcContext.m_strName );
+    g_strTraceChunk += "}}";
+
+    g_vTracedVMs.push_back( std::move( cTracedVM ) );
+  }
+
+
+  void TraceRemoveVM( rumDebugContext& io_rcContext )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+    const auto& iter{ std::find_if( g_vTracedVMs.begin(), g_vTracedVMs.end(), [&io_rcContext]( const auto& i_rcVM )
+    {
+      return i_rcVM.m_pcContext == &io_rcContext;
+    } ) };
+
+    if( iter != g_vTracedVMs.end() )
+    {
+      DrainTraceEvents( *iter );
+      EndOpenCalls( *iter, rumDebugTraceEvent::ToTimeNS( std::chrono::steady_clock::now() ) );
+      FlushTraceChunk( false );
+
+      g_vTracedVMs.erase( iter );
+    }
+  }
+
+
+  bool TraceStart( const std::filesystem::path& i_fsFilePath )
+  {
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+      if( g_bTracing )
+      {
+        return false;
+      }
+
+      g_cTraceFile.open( i_fsFilePath, std::ios::binary | std::ios::trunc );
+      if( !g_cTraceFile.is_open() )
+      {
+        g_cTraceFile.clear();
+        g_strLastError = "Failed to open " + i_fsFilePath.generic_string();
+        return false;
+      }
+
+      g_strLastError.clear();
+      g_strTraceChunk.clear();
+      g_strTraceChunk.reserve( EXPORT_CHUNK_BYTES + 1024 );
+      g_strTraceChunk += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+      g_iTraceStartNS = rumDebugTraceEvent::ToTimeNS( std::chrono::steady_clock::now() );
+      g_uiNextTraceThreadID = 1;
+      g_bTraceHasEvents = false;
+      g_bTracing = true;
+
+      StartWriterThread();
+    }
+
+    g_cvExport.notify_all();
+
+    return true;
+  }
+
+
+  void TraceStop()
+  {
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+      if( !g_bTracing )
+      {
+        return;
+      }
+
+      const int64_t iTimeNS{ rumDebugTraceEvent::ToTimeNS( std::chrono::steady_clock::now() ) };
+      for( auto& iter : g_vTracedVMs )
+      {
+        DrainTraceEvents( iter );
+        EndOpenCalls( iter, iTimeNS );
+      }
+
+      g_vTracedVMs.clear();
+
+      g_strTraceChunk += "\n]}\n";
+      FlushTraceChunk( true );
+
+      g_cTraceFile.close();
+      g_cTraceFile.clear();
+
+      // Release the chunk's memory between traces
+      std::string().swap( g_strTraceChunk );
+
+      g_bTracing = false;
+    }
+
+    g_cvExport.notify_all();
+  }
+
+
+  void Update()
+  {
+    std::thread cWriterThread;
+
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxExportLock );
+
+      if( g_bWriterDone )
+      {
+        cWriterThread = std::move( g_cWriterThread );
+      }
+    }
+
+    if( cWriterThread.joinable() )
+    {
+      cWriterThread.join();
+    }
+  }
+
+
+  bool WriteCollapsedStacks( const rumDebugCallTree& i_rcCallTree, rumDebugProfileSource i_eSource,
+                             const std::filesystem::path& i_fsFilePath )
+  {
+    std::ofstream cFile( i_fsFilePath, std::ios::binary | std::ios::trunc );
+    if( !cFile.is_open() )
+    {
+      return false;
+    }
+
+    const auto& rcvNodes{ i_rcCallTree.m_vNodes };
+    const bool bSampled{ rumDebugProfileSource::Sampled == i_eSource };
+
+    std::string strChunk;
+    strChunk.reserve( EXPORT_CHUNK_BYTES + 1024 );
+
+    // The nodes are visited depth first, so the path to each node begins with the path to its parent
+    struct PendingNode
+    {
+      uint32_t m_uiNode{ 0 };
+      size_t m_szParentPathLength{ 0 };
+    };
+
+    std::vector<PendingNode> vPendingNodes;
+    for( uint32_t uiChild{ rcvNodes[0].m_uiFirstChild }; uiChild != rumDebugCallTree::s_uiInvalidIndex;
+         uiChild = rcvNodes[uiChild].m_uiNextSibling )
+    {
+      vPendingNodes.push_back( { uiChild, 0 } );
+    }
+
+    std::string strPath;
+    while( !vPendingNodes.empty() )
+    {
+      const PendingNode cPendingNode{ vPendingNodes.back() };
+      vPendingNodes.pop_back();
+
+      const rumDebugCallTree::Node& rcNode{ rcvNodes[cPendingNode.m_uiNode] };
+
+      strPath.resize( cPendingNode.m_szParentPathLength );
+      if( !strPath.empty() )
+      {
+        strPath += ';';
+      }
+
+      AppendFrameName( strPath, i_rcCallTree.m_vFunctions[rcNode.m_uiFunction] );
+
+      // Only time spent in the function itself belongs to its path, since its callees have paths of their own
+      const int64_t iExclusiveUS{ std::max<int64_t>( rcNode.m_iExclusiveNS, 0 ) / 1000 };
+      const uint64_t uiWeight{ bSampled ? rcNode.m_uiNumCalls : static_cast<uint64_t>( iExclusiveUS ) };
+      if( uiWeight > 0 )
+      {
+        strChunk += strPath;
+        strChunk += ' ';
+        strChunk += std::to_string( uiWeight );
+        strChunk += '\n';
+
+        FlushChunk( cFile, strChunk, false );
+      }
+
+      for( uint32_t uiChild{ rcNode.m_uiFirstChild }; uiChild != rumDebugCallTree::s_uiInvalidIndex;
+           uiChild = rcvNodes[uiChild].m_uiNextSibling )
+      {
+        vPendingNodes.push_back( { uiChild, strPath.size() } );
+      }
+    }
+
+    FlushChunk( cFile, strChunk, true );
+    cFile.close();
+
+    return !cFile.fail();
+  }
+
+
+  bool WriteLineCoverage( const std::vector<CoveredFile>& i_vCoveredFiles, const std::filesystem::path& i_fsFilePath )
+  {
+    std::ofstream cFile( i_fsFilePath, std::ios::binary | std::ios::trunc );
+    if( !cFile.is_open() )
+    {
+      return false;
+    }
+
+    std::string strChunk;
+    strChunk.reserve( EXPORT_CHUNK_BYTES + 1024 );
+
+    strChunk += "TN:\n";
+
+    for( const auto& fileIter : i_vCoveredFiles )
+    {
+      std::error_code cErrorCode;
+      const std::filesystem::path fsAbsolutePath{ std::filesystem::absolute( fileIter.m_fsFilePath, cErrorCode ) };
+
+      strChunk += "SF:";
+      strChunk += ( cErrorCode ? fileIter.m_fsFilePath : fsAbsolutePath ).generic_string();
+      strChunk += '\n';
+
+      uint32_t uiNumLinesFound{ 0 };
+      uint32_t uiNumLinesHit{ 0 };
+
+      const auto AppendLine{ [&]( uint32_t i_uiLine, bool i_bHit )
+      {
+        strChunk += "DA:";
+        strChunk += std::to_string( i_uiLine );
+        strChunk += i_bHit ? ",1\n" : ",0\n";
+
+        ++uiNumLinesFound;
+        uiNumLinesHit += i_bHit ? 1 : 0;
+
+        FlushChunk( cFile, strChunk, false );
+      } };
+
+      // Only executed lines are recorded, so the source is read for the lines that could have executed but didn't
+      uint32_t uiLine{ 0 };
+      std::ifstream cSourceFile( fileIter.m_fsFilePath, std::ios::binary );
+      if( cSourceFile.is_open() )
+      {
+        bool bInBlockComment{ false };
+        std::string strLine;
+        while( std::getline( cSourceFile, strLine ) )
+        {
+          ++uiLine;
+
+          const bool bHit{ rumDebugLineCoverage::IsLineCovered( fileIter.m_vLines, uiLine ) };
+          if( rumDebugUtility::IsExecutableLine( strLine, bInBlockComment ) || bHit )
+          {
+            AppendLine( uiLine, bHit );
+          }
+        }
+      }
+
+      // Covered lines past the end of the source, or all covered lines if the source couldn't be read
+      const auto uiNumLines{ static_cast<uint32_t>( fileIter.m_vLines.size() * 64 ) };
+      for( ++uiLine; uiLine < uiNumLines; ++uiLine )
+      {
+        if( rumDebugLineCoverage::IsLineCovered( fileIter.m_vLines, uiLine ) )
+        {
+          AppendLine( uiLine, true );
+        }
+      }
+
+      strChunk += "LF:";
+      strChunk += std::to_string( uiNumLinesFound );
+      strChunk += "\nLH:";
+      strChunk += std::to_string( uiNumLinesHit );
+      strChunk += "\nend_of_record\n";
+    }
+
+    FlushChunk( cFile, strChunk, true );
+    cFile.close();
+
+    return !cFile.fail();
+  }
+
+
+  void WriteTraceEvent( TracedVM& io_rcTracedVM, const rumDebugTraceEvent& i_rcEvent )
+  {
+    const uint32_t uiThreadID{ io_rcTracedVM.m_uiThreadID };
+
+    switch( i_rcEvent.m_eType )
+    {
+      case rumDebugTraceEvent::Type::Call:
+      {
+        const rumDebugProfileFunction& rcFunction{ GetFunction( io_rcTracedVM, i_rcEvent.m_uiFunction ) };
+
+        BeginTraceEvent( 'B', uiThreadID, i_rcEvent.m_iTimeNS );
+        g_strTraceChunk += ",\"cat\":\"call\",\"name\":";
+        AppendJSONString( g_strTraceChunk, rcFunction.m_strFunction.empty() ? "(anonymous)"
+                                                                            : rcFunction.m_strFunction );
+        g_strTraceChunk += ",\"args\":{\"source\":";
+        AppendJSONString( g_strTraceChunk, rcFunction.m_strSource );
+        g_strTraceChunk += ",\"line\":";
+        g_strTraceChunk += std::to_string( rcFunction.m_iLine );
+        g_strTraceChunk += "}}";
+
+        io_rcTracedVM.m_viOpenCallDepths.push_back( i_rcEvent.m_iCallDepth );
+        break;
+      }
+
+      case rumDebugTraceEvent::Type::Return:
+      {
+        auto& rviOpenCallDepths{ io_rcTracedVM.m_viOpenCallDepths };
+
+        // Calls deeper than the returning one lost their returns to a full buffer, or never returned, such as calls
+        // into a generator that suspended. They end here so that this return can't close one of them instead.
+        while( !rviOpenCallDepths.empty() && rviOpenCallDepths.back() > i_rcEvent.m_iCallDepth )
+        {
+          BeginTraceEvent( 'E', uiThreadID, i_rcEvent.m_iTimeNS );
+          g_strTraceChunk += '}';
+          rviOpenCallDepths.pop_back();
+        }
+
+        // Otherwise the returning call was entered before the trace started, or was dropped from a full buffer
+        if( !rviOpenCallDepths.empty() && rviOpenCallDepths.back() == i_rcEvent.m_iCallDepth )
+        {
+          BeginTraceEvent( 'E', uiThreadID, i_rcEvent.m_iTimeNS );
+          g_strTraceChunk += '}';
+          rviOpenCallDepths.pop_back();
+        }
+        break;
+      }
+
+      case rumDebugTraceEvent::Type::Sample:
+      {
+        const rumDebugProfileFunction& rcFunction{ GetFunction( io_rcTracedVM, i_rcEvent.m_uiFunction ) };
+
+        // A thread-scoped instant event at the sampled line
+        BeginTraceEvent( 'i', uiThreadID, i_rcEvent.m_iTimeNS );
+        g_strTraceChunk += ",\"s\":\"t\",\"cat\":\"sample\",\"name\":";
+        AppendJSONString( g_strTraceChunk, rcFunction.m_strFunction.empty() ? "(anonymous)"
+                                                                            : rcFunction.m_strFunction );
+        g_strTraceChunk += ",\"args\":{\"source\":";
+        AppendJSONString( g_strTraceChunk, rcFunction.m_strSource );
+        g_strTraceChunk += ",\"line\":";
+        g_strTraceChunk += std::to_string( i_rcEvent.m_uiLine );
+        g_strTraceChunk += "}}";
+        break;
+      }
+
+      case rumDebugTraceEvent::Type::Pause:
+      {
+        BeginTraceEvent( 'X', uiThreadID, i_rcEvent.m_iTimeNS );
+
+        char strDuration[32];
+        snprintf( strDuration, sizeof( strDuration ), ",\"dur\":%.3f", i_rcEvent.m_iDurationNS / 1.0e3 );
+        g_strTraceChunk += strDuration;
+        g_strTraceChunk += ",\"cat\":\"debugger\",\"name\":\"Paused\"}";
+        break;
+      }
+    }
+
+    FlushTraceChunk( false );
+  }
+
+
+  void WriterThread()
+  {
+    std::unique_lock<std::mutex> ulock( g_mtxExportLock );
+
+    for( ;; )
+    {
+      while( !g_qExports.empty() )
+      {
+        const QueuedExport cExport{ std::move( g_qExports.front() ) };
+        g_qExports.pop_front();
+
+        // Nothing else touches a dequeued export, so it's written without holding up the trace
+        ulock.unlock();
+        const bool bWritten{ cExport.m_fnWrite( cExport.m_fsFilePath ) };
+        ulock.lock();
+
+        if( !bWritten )
+        {
+          g_strLastError = "Failed to write " + cExport.m_fsFilePath.generic_string();
+        }
+      }
+
+      if( !g_bTracing )
+      {
+        g_bWriterDone = true;
+        return;
+      }
+
+      for( auto& iter : g_vTracedVMs )
+      {
+        DrainTraceEvents( iter );
+      }
+
+      g_cvExport.wait_for( ulock, std::chrono::milliseconds( EXPORT_WRITE_INTERVAL_MS ), []
+      {
+        return !g_bTracing || !g_qExports.empty();
+      } );
+    }
+  }
+} // namespace rumDebugExport
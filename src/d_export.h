@@ -0,0 +1,57 @@
+#pragma once
+
+#include <d_context.h>
+#include <d_profiler.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Writes profiling data to files for external tools. All writing happens on a background writer thread in chunks of
+// about EXPORT_CHUNK_BYTES, so long captures are never held in memory. Traces are written as Chrome trace event JSON,
+// which Perfetto and chrome://tracing open, call trees in the collapsed stack format read by flame graph tools, and
+// line coverage in the lcov tracefile format.
+
+namespace rumDebugExport
+{
+  // A file's covered lines, one bit per line
+  struct CoveredFile
+  {
+    std::filesystem::path m_fsFilePath;
+    std::vector<uint64_t> m_vLines;
+  };
+
+  // Queues the call tree to be written as collapsed stacks, one line per call path. Paths are weighted by exclusive
+  // microseconds, or by the number of samples for sampled call trees.
+  void ExportCollapsedStacks( std::shared_ptr<const rumDebugCallTree> i_pcCallTree, rumDebugProfileSource i_eSource,
+                              const std::filesystem::path& i_fsFilePath );
+
+  // Queues the covered files to be written as an lcov tracefile. Each file's source is read to find the lines that
+  // could have executed, which are reported as missed unless covered.
+  void ExportLineCoverage( std::vector<CoveredFile> i_vCoveredFiles, const std::filesystem::path& i_fsFilePath );
+
+  // The most recent error from writing an export, or empty if there has been none
+  std::string GetLastError();
+
+  bool IsTracing();
+
+  // Finishes the trace and any queued exports, then stops the writer thread
+  void Shutdown();
+
+  // Adds the VM's trace events to the trace from now on. Events left in the VM's trace buffer from an earlier trace
+  // are discarded.
+  void TraceAddVM( rumDebugContext& io_rcContext );
+
+  // Writes the VM's remaining trace events and ends its unfinished calls
+  void TraceRemoveVM( rumDebugContext& io_rcContext );
+
+  // Opens the file and starts a trace. Returns false if a trace is already recording or the file can't be opened.
+  bool TraceStart( const std::filesystem::path& i_fsFilePath );
+
+  // Writes the remaining events of every traced VM and closes the file
+  void TraceStop();
+
+  // Reclaims the writer thread once it has run out of work
+  void Update();
+} // namespace rumDebugExport
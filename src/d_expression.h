@@ -0,0 +1,30 @@
+#pragma once
+
+#include <squirrel.h>
+
+#include <string>
+#include <vector>
+
+// Represents a script expression compiled into a closure that receives the local variables of the frame it is
+// evaluated in as parameters. Closures belong to the VM that compiled them, so expressions are cached per VM.
+
+struct rumDebugExpression
+{
+  // The expression source
+  std::string m_strExpression;
+
+  // The local variable names the closure was compiled against, in stack order
+  std::vector<std::string> m_vLocalNames;
+
+  // The most recent compile or evaluation error
+  std::string m_strError;
+
+  // The compiled closure, which holds a reference while m_bCompiled is set
+  HSQOBJECT m_sqClosure;
+
+  bool m_bCompiled{ false };
+
+  // Set when the expression failed to compile or exceeded its time budget. A failed expression is not evaluated again
+  // until its source changes.
+  bool m_bFailed{ false };
+};
@@ -34,6 +34,8 @@ SOFTWARE.
 #include <d_variable.h>
 #include <d_vm.h>
 
+#include <atomic>
+#include <cmath>
 #include <mutex>
 #include <regex>
 
@@ -70,6 +72,30 @@ namespace rumDebugInterface
   // Show integer values as hex
   bool g_bShowHex{ false };
 
+  // Logpoint output, kept as a single buffer plus the offset of each line so that only visible lines are touched
+  ImGuiTextBuffer g_cConsoleBuffer;
+  ImVector<int32_t> g_vConsoleLineOffsets;
+
+  // Should the console follow new output?
+  bool g_bConsoleAutoScroll{ true };
+
+  // Whether the Profiler tab and the source code heat gutter show timed calls and executed lines, or samples
+  rumDebugProfileSource g_eProfileSource{ rumDebugProfileSource::Instrumented };
+
+  // Frame timings of each panel and their display names, indexed by rumDebugPanel
+  rumDebugPanelCounters g_cPanelCounters[static_cast<size_t>( rumDebugPanel::NumPanels )];
+  const char* const g_strPanelNames[static_cast<size_t>( rumDebugPanel::NumPanels )]
+  {
+    "Frame", "File Explorer", "Source Code", "Watched", "Locals", "Callstack", "Breakpoints", "Console", "Profiler",
+    "VMs"
+  };
+
+  // Set from any thread to have the interface thread clear the panel frame timings
+  std::atomic<bool> g_bPanelTimingsResetRequested{ false };
+
+  // Should the Debugger Stats window be shown?
+  bool g_bShowStats{ false };
+
 
   ///////////////
   // Prototypes
@@ -79,11 +105,19 @@ namespace rumDebugInterface
                     bool i_bInMultilineComment );
   void DisplayVariable( const rumDebugVariable& i_rcVariable );
 
+  // Adds a row for each child of an expanded variable, fetching them from the paused VM if needed
+  void DisplayVariableChildren( uint32_t i_uiHandle );
+
+  // Shows a variable's value in the current column, with a button to expand values too long to preview
+  void DisplayVariableValue( const rumDebugVariable& i_rcVariable );
+
   void DoVariableExpansion( const rumDebugVariable& i_rcVariable );
 
   size_t FindNthOccurrence( const std::string_view i_strSource, const std::string_view i_strFind,
                             size_t i_szOccurence, size_t i_szOffset = 0 );
 
+  rumDebugPanelCounters& GetPanelCounters( rumDebugPanel i_ePanel );
+
   rumDebugVariable GetVariable( const std::string& i_strName );
 
   void Settings_ReadLine( ImGuiContext* i_pcContext, ImGuiSettingsHandler* i_pcSettingsHandler, void* i_pcEntry,
@@ -94,14 +128,20 @@ namespace rumDebugInterface
                           ImGuiTextBuffer* io_pcBuffer );
 
   void UpdateBreakpointTab();
+  void UpdateConsole();
+  void UpdateConsoleTab();
   void UpdateDisplayFolder( const std::string& i_strFolder,
                             std::filesystem::recursive_directory_iterator& i_rcIter,
                             std::filesystem::recursive_directory_iterator& i_rcIterEnd,
                             const std::string& i_strFilter );
   void UpdateFileExplorer();
+  void UpdateFunctionBreakpoints();
   void UpdateLocalsTab();
   void UpdateKeyDirectives();
   void UpdatePrimaryRow( float i_fHeight );
+  void UpdateProfilerFlameGraph( const rumDebugCallTree& i_rcCallTree );
+  void UpdateProfilerFunctions( const std::shared_ptr<const rumDebugCallTree>& i_pcCallTree );
+  void UpdateProfilerTab();
   void UpdateSecondaryRow();
   void UpdateSettings();
   void UpdateSkipChildren( const std::string& i_strFolder,
@@ -110,6 +150,7 @@ namespace rumDebugInterface
   void UpdateSourceCode();
   void UpdateStackBreakpointWindow();
   void UpdateStackTab();
+  void UpdateStatsWindow();
   void UpdateVMsTab();
   void UpdateWatchLocalWindow();
   void UpdateWatchTab();
@@ -119,9 +160,19 @@ namespace rumDebugInterface
   {
     ImGui::TableNextRow();
 
-    // The local variable name
+    // The local variable name, expandable if the variable has children
     ImGui::TableNextColumn();
-    ImGui::TextUnformatted( i_rcVariable.m_strName.c_str() );
+
+    bool bOpen{ false };
+    if( i_rcVariable.m_uiHandle != 0 )
+    {
+      bOpen = ImGui::TreeNodeEx( i_rcVariable.m_strName.c_str(), ImGuiTreeNodeFlags_SpanFullWidth );
+    }
+    else
+    {
+      ImGui::TreeNodeEx( i_rcVariable.m_strName.c_str(), ImGuiTreeNodeFlags_Leaf |
+                         ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth );
+    }
 
     // The local variable type
     ImGui::TableNextColumn();
@@ -129,9 +180,83 @@ namespace rumDebugInterface
 
     // The local variable value
     ImGui::TableNextColumn();
+    DisplayVariableValue( i_rcVariable );
+
+    if( bOpen )
+    {
+      DisplayVariableChildren( i_rcVariable.m_uiHandle );
+      ImGui::TreePop();
+    }
+  }
+
+
+  void DisplayVariableChildren( uint32_t i_uiHandle )
+  {
+    uint32_t uiNumChildren{ 0 };
+    if( !rumDebugVM::GetNumVariableChildren( i_uiHandle, uiNumChildren ) )
+    {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextDisabled( "Fetching..." );
+      return;
+    }
+
+    // Containers can be huge, so only the visible rows are submitted and only their pages are fetched. Rows are
+    // assumed to be one line high, so a child expanded within a long list can throw off the scroll position.
+    std::vector<rumDebugVariable> vPage;
+    uint32_t uiPage{ UINT32_MAX };
+    bool bPageFetched{ false };
+
+    ImGuiListClipper cClipper;
+    cClipper.Begin( static_cast<int32_t>( uiNumChildren ) );
+    while( cClipper.Step() )
+    {
+      for( int32_t iRow{ cClipper.DisplayStart }; iRow < cClipper.DisplayEnd; ++iRow )
+      {
+        const uint32_t uiRowPage{ static_cast<uint32_t>( iRow ) / VARIABLE_PAGE_SIZE };
+        if( uiRowPage != uiPage )
+        {
+          uiPage = uiRowPage;
+          vPage.clear();
+          bPageFetched = rumDebugVM::GetVariableChildren( i_uiHandle, uiPage, vPage );
+        }
+
+        const size_t szIndex{ static_cast<uint32_t>( iRow ) % VARIABLE_PAGE_SIZE };
+        if( szIndex < vPage.size() )
+        {
+          DisplayVariable( vPage[szIndex] );
+        }
+        else
+        {
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          if( !bPageFetched )
+          {
+            ImGui::TextDisabled( "Fetching..." );
+          }
+        }
+      }
+    }
+
+    cClipper.End();
+  }
 
-    // Preview the results if there are more than 3 lines
-    const auto szOffset{ FindNthOccurrence( i_rcVariable.m_strValue, "\n", NUM_VARIABLE_PREVIEW_LINES ) };
+
+  void DisplayVariableValue( const rumDebugVariable& i_rcVariable )
+  {
+    // Values that changed since the last pause are highlighted
+    constexpr ImVec4 uiChangedColor{ 0.95f, 0.45f, 0.35f, 1.0f };
+
+    if( i_rcVariable.m_bChanged )
+    {
+      ImGui::PushStyleColor( ImGuiCol_Text, uiChangedColor );
+    }
+
+    // Containers are only summarized, but their full description can be fetched on request. Other values are
+    // previewed if there are more than 3 lines.
+    const bool bContainer{ i_rcVariable.m_uiHandle != 0 };
+    const auto szOffset{ bContainer ? std::string::npos
+                                    : FindNthOccurrence( i_rcVariable.m_strValue, "\n", NUM_VARIABLE_PREVIEW_LINES ) };
     if( szOffset == std::string::npos )
     {
       ImGui::TextUnformatted( i_rcVariable.m_strValue.c_str() );
@@ -139,6 +264,20 @@ namespace rumDebugInterface
     else
     {
       ImGui::TextUnformatted( i_rcVariable.m_strValue.substr( 0, szOffset ).c_str() );
+    }
+
+    if( i_rcVariable.m_bChanged )
+    {
+      ImGui::PopStyleColor();
+    }
+
+    if( bContainer )
+    {
+      ImGui::SameLine();
+      DoVariableExpansion( i_rcVariable );
+    }
+    else if( szOffset != std::string::npos )
+    {
       DoVariableExpansion( i_rcVariable );
     }
   }
@@ -156,9 +295,17 @@ namespace rumDebugInterface
     if( ImGui::BeginPopupModal( i_rcDebugVariable.m_strName.c_str(), nullptr,
                                 ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_HorizontalScrollbar ) )
     {
+      // The full description of a container is only built once asked for
+      std::string strValue{ i_rcDebugVariable.m_strValue };
+      if( i_rcDebugVariable.m_uiHandle != 0 &&
+          !rumDebugVM::GetVariableDescription( i_rcDebugVariable.m_uiHandle, strValue ) )
+      {
+        strValue = "Fetching...";
+      }
+
       if( ImGui::SmallButton( "Copy" ) )
       {
-        ImGui::SetClipboardText( i_rcDebugVariable.m_strValue.c_str() );
+        ImGui::SetClipboardText( strValue.c_str() );
       }
 
       ImGui::SameLine();
@@ -169,7 +316,7 @@ namespace rumDebugInterface
 
       ImGui::Text( i_rcDebugVariable.m_strType.c_str() );
       ImGui::Separator();
-      ImGui::TextUnformatted( i_rcDebugVariable.m_strValue.c_str() );
+      ImGui::TextUnformatted( strValue.c_str() );
 
       ImGui::EndPopup();
     }
@@ -340,6 +487,33 @@ namespace rumDebugInterface
   }
 
 
+  rumDebugPanelCounters& GetPanelCounters( rumDebugPanel i_ePanel )
+  {
+    return g_cPanelCounters[static_cast<size_t>( i_ePanel )];
+  }
+
+
+  std::vector<rumDebugPanelTiming> GetPanelTimings()
+  {
+    std::vector<rumDebugPanelTiming> vTimings;
+    vTimings.reserve( static_cast<size_t>( rumDebugPanel::NumPanels ) );
+
+    for( size_t szPanel{ 0 }; szPanel < static_cast<size_t>( rumDebugPanel::NumPanels ); ++szPanel )
+    {
+      const rumDebugPanelCounters& rcCounters{ g_cPanelCounters[szPanel] };
+      const uint64_t uiNumFrames{ rcCounters.m_uiNumFrames.load( std::memory_order_relaxed ) };
+
+      rumDebugPanelTiming& rcTiming{ vTimings.emplace_back() };
+      rcTiming.m_strName = g_strPanelNames[szPanel];
+      rcTiming.m_uiLastNS = rcCounters.m_uiLastNS.load( std::memory_order_relaxed );
+      rcTiming.m_uiAverageNS = uiNumFrames > 0 ? rcCounters.m_uiTotalNS.load( std::memory_order_relaxed ) / uiNumFrames
+                                               : 0;
+    }
+
+    return vTimings;
+  }
+
+
   rumDebugVariable GetVariable( const std::string& i_strVariableName )
   {
     rumDebugVariable cVariable;
@@ -423,6 +597,12 @@ namespace rumDebugInterface
   }
 
 
+  void RequestPanelTimingsReset()
+  {
+    g_bPanelTimingsResetRequested.store( true, std::memory_order_relaxed );
+  }
+
+
   void RequestSettingsUpdate()
   {
     std::lock_guard<std::mutex> cLockGuard( g_mtxLockGuard );
@@ -443,8 +623,19 @@ namespace rumDebugInterface
                           [[maybe_unused]] void* i_pcEntry,
                           const char* i_strLine )
   {
+    // Conditions and log messages follow the breakpoint they belong to
+    static rumDebugBreakpoint cLastBreakpoint;
+
     std::string strLine( i_strLine );
-    if( strLine.find_first_of( "Breakpoint" ) == 0 )
+    if( strLine.rfind( "BreakpointCondition", 0 ) == 0 )
+    {
+      rumDebugVM::BreakpointSetCondition( cLastBreakpoint, strLine.substr( strLine.find_first_of( '=' ) + 1 ) );
+    }
+    else if( strLine.rfind( "BreakpointLogMessage", 0 ) == 0 )
+    {
+      rumDebugVM::BreakpointSetLogMessage( cLastBreakpoint, strLine.substr( strLine.find_first_of( '=' ) + 1 ) );
+    }
+    else if( strLine.rfind( "Breakpoint", 0 ) == 0 )
     {
       size_t szLineNumberStart{ strLine.find_first_of( '=' ) + 1 };
       size_t szBreakpointEnabled{ strLine.find_first_of( ',' ) + 1 };
@@ -459,15 +650,35 @@ namespace rumDebugInterface
         rumDebugBreakpoint cBreakpoint( fsFilePath, std::stoi( strLineNumber ),
                                         strBreakpointEnabled.compare( "1" ) == 0 ? true : false );
         rumDebugVM::BreakpointAdd( cBreakpoint );
+
+        cLastBreakpoint = cBreakpoint;
+      }
+    }
+    else if( strLine.rfind( "FunctionBreakpoint", 0 ) == 0 )
+    {
+      size_t szEnabledStart{ strLine.find_first_of( '=' ) + 1 };
+      size_t szHitCountStart{ strLine.find( ',', szEnabledStart ) };
+      size_t szNameStart{ szHitCountStart == std::string::npos ? std::string::npos
+                                                               : strLine.find( ',', szHitCountStart + 1 ) };
+
+      if( szHitCountStart != std::string::npos && szNameStart != std::string::npos )
+      {
+        std::string strEnabled{ strLine.substr( szEnabledStart, 1 ) };
+        std::string strHitCount{ strLine.substr( szHitCountStart + 1, szNameStart - szHitCountStart - 1 ) };
+
+        rumDebugFunctionBreakpoint cBreakpoint( strLine.substr( szNameStart + 1 ),
+                                                strEnabled.compare( "1" ) == 0 ? true : false );
+        cBreakpoint.m_uiHitCount = static_cast<uint32_t>( std::stoul( strHitCount ) );
+        rumDebugVM::FunctionBreakpointAdd( cBreakpoint );
       }
     }
-    else if( strLine.find_first_of( "File" ) == 0 )
+    else if( strLine.rfind( "File", 0 ) == 0 )
     {
       constexpr int32_t iFocusLineNumber{ 0 };
       std::filesystem::path fsFilePath{ strLine.substr( strLine.find_first_of( "=" ) + 1 ) };
       rumDebugVM::FileOpen( fsFilePath, iFocusLineNumber );
     }
-    else if( strLine.find_first_of( "WatchVariable" ) == 0 )
+    else if( strLine.rfind( "WatchVariable", 0 ) == 0 )
     {
       rumDebugVM::WatchVariableAdd( strLine.substr( strLine.find_first_of( "=" ) + 1 ) );
     }
@@ -502,13 +713,32 @@ namespace rumDebugInterface
     for( const auto& iter : rumDebugVM::GetBreakpointsRef() )
     {
       io_pcBuffer->appendf( "Breakpoint%d=%d,%d,%s\n",
-                            uiBreakpointIndex++, iter.m_uiLine, iter.m_bEnabled ? 1 : 0,
+                            uiBreakpointIndex, iter.m_uiLine, iter.m_bEnabled ? 1 : 0,
                             iter.m_fsFilepath.generic_string().c_str() );
+
+      if( !iter.m_strCondition.empty() )
+      {
+        io_pcBuffer->appendf( "BreakpointCondition%d=%s\n", uiBreakpointIndex, iter.m_strCondition.c_str() );
+      }
+
+      if( !iter.m_strLogMessage.empty() )
+      {
+        io_pcBuffer->appendf( "BreakpointLogMessage%d=%s\n", uiBreakpointIndex, iter.m_strLogMessage.c_str() );
+      }
+
+      ++uiBreakpointIndex;
 #if DEBUG_OUTPUT
       std::cout << "Saving Breakpoint: " << iter.m_uiLine << '\n';
 #endif
     }
 
+    uint32_t uiFunctionBreakpointIndex{ 1 };
+    for( const auto& iter : rumDebugVM::GetFunctionBreakpointsRef() )
+    {
+      io_pcBuffer->appendf( "FunctionBreakpoint%d=%d,%u,%s\n", uiFunctionBreakpointIndex++, iter.m_bEnabled ? 1 : 0,
+                            iter.m_uiHitCount, iter.GetQualifiedName().c_str() );
+    }
+
     uint32_t uiFileIndex{ 1 };
     for( const auto& iter : rumDebugVM::GetOpenedFilesRef() )
     {
@@ -558,7 +788,20 @@ namespace rumDebugInterface
     }
 #endif // DEBUG_OUTPUT
 
+    if( g_bPanelTimingsResetRequested.exchange( false, std::memory_order_relaxed ) )
+    {
+      for( auto& iter : g_cPanelCounters )
+      {
+        iter.m_uiLastNS.store( 0, std::memory_order_relaxed );
+        iter.m_uiTotalNS.store( 0, std::memory_order_relaxed );
+        iter.m_uiNumFrames.store( 0, std::memory_order_relaxed );
+      }
+    }
+
+    const rumDebugPanelTimer cFrameTimer( GetPanelCounters( rumDebugPanel::Frame ) );
+
     UpdateKeyDirectives();
+    UpdateConsole();
 
     NetImgui::NewFrame();
 
@@ -596,6 +839,11 @@ namespace rumDebugInterface
     // Script Debugger window
     ImGui::End();
 
+    if( g_bShowStats )
+    {
+      UpdateStatsWindow();
+    }
+
     //ImGui::ShowDemoWindow();
 
     NetImgui::EndFrame();
@@ -611,6 +859,8 @@ namespace rumDebugInterface
   {
     if( ImGui::BeginTabItem( "Breakpoints##TabItem" ) )
     {
+      const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::Breakpoints ) );
+
       const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
       const ImVec2 cSize{ 0.0f, std::max( 0.0f, vRegion.y - 2.0f ) };
       ImGui::BeginChild( "BreakpointsTabChild", cSize, false, ImGuiWindowFlags_HorizontalScrollbar );
@@ -623,11 +873,14 @@ namespace rumDebugInterface
       }
       else
       {
-        constexpr int32_t iNumColumns{ 3 };
+        constexpr int32_t iNumColumns{ 5 };
         constexpr ImGuiTableFlags eTableFlags{ ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchProp |
                                                ImGuiTableFlags_Borders | ImGuiTableFlags_NoSavedSettings };
         if( ImGui::BeginTable( "BreakpointsTable", iNumColumns, eTableFlags ) )
         {
+          static char strCCondition[MAX_EXPRESSION_LENGTH];
+          static char strCLogMessage[MAX_EXPRESSION_LENGTH];
+
           rumDebugBreakpoint cRemovedBreakpoint;
           bool bBreakpointRemoved{ false };
 
@@ -674,6 +927,43 @@ namespace rumDebugInterface
                 rumDebugVM::FileOpen( iter.m_fsFilepath, iter.m_uiLine );
               }
             }
+
+            // The breakpoint condition, which is applied when Enter is pressed
+            ImGui::TableNextColumn();
+
+            ImGui::PushItemWidth( ImGui::GetColumnWidth() );
+
+            strncpy_s( strCCondition, iter.m_strCondition.c_str(), MAX_EXPRESSION_LENGTH - 1 );
+            std::string strContentID{ "##Condition" + iter.m_fsFilepath.generic_string() +
+                                      std::to_string( iter.m_uiLine ) };
+            if( ImGui::InputTextWithHint( strContentID.c_str(), "condition", strCCondition,
+                                          IM_ARRAYSIZE( strCCondition ), ImGuiInputTextFlags_EnterReturnsTrue ) )
+            {
+              rumDebugVM::BreakpointSetCondition( iter, strCCondition );
+            }
+
+            ImGui::PopItemWidth();
+
+            // The logpoint message, which turns the breakpoint into a logpoint when set
+            ImGui::TableNextColumn();
+
+            ImGui::PushItemWidth( ImGui::GetColumnWidth() );
+
+            strncpy_s( strCLogMessage, iter.m_strLogMessage.c_str(), MAX_EXPRESSION_LENGTH - 1 );
+            strContentID = "##LogMessage" + iter.m_fsFilepath.generic_string() + std::to_string( iter.m_uiLine );
+            if( ImGui::InputTextWithHint( strContentID.c_str(), "log message", strCLogMessage,
+                                          IM_ARRAYSIZE( strCLogMessage ), ImGuiInputTextFlags_EnterReturnsTrue ) )
+            {
+              rumDebugVM::BreakpointSetLogMessage( iter, strCLogMessage );
+            }
+
+            ImGui::PopItemWidth();
+
+            if( !iter.m_strError.empty() )
+            {
+              // Errors don't stop execution, so they are surfaced here instead
+              ImGui::TextColored( { 1.0f, 0.4f, 0.4f, 1.0f }, "%s", iter.m_strError.c_str() );
+            }
           }
 
           if( bBreakpointRemoved )
@@ -686,6 +976,8 @@ namespace rumDebugInterface
         }
       }
 
+      UpdateFunctionBreakpoints();
+
       // BreakpointsTabChild
       ImGui::EndChild();
 
@@ -695,6 +987,90 @@ namespace rumDebugInterface
   }
 
 
+  void UpdateConsole()
+  {
+    // Drain every frame, even when the Console tab isn't visible, so that the logpoint buffer doesn't fill up
+    rumDebugVM::DrainLogMessages( []( const char* i_strMessage, size_t i_szLength )
+    {
+      const int32_t iStart{ g_cConsoleBuffer.size() };
+      g_cConsoleBuffer.append( i_strMessage, i_strMessage + i_szLength );
+      g_cConsoleBuffer.append( "\n" );
+
+      // Multi-line messages are split so that every console line has the same height for clipping
+      g_vConsoleLineOffsets.push_back( iStart );
+      for( int32_t i{ iStart }; i < g_cConsoleBuffer.size() - 1; ++i )
+      {
+        if( '\n' == g_cConsoleBuffer[i] )
+        {
+          g_vConsoleLineOffsets.push_back( i + 1 );
+        }
+      }
+    } );
+  }
+
+
+  void UpdateConsoleTab()
+  {
+    if( ImGui::BeginTabItem( "Console##TabItem" ) )
+    {
+      const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::Console ) );
+
+      if( ImGui::SmallButton( "Clear" ) )
+      {
+        g_cConsoleBuffer.clear();
+        g_vConsoleLineOffsets.clear();
+      }
+
+      ImGui::SameLine();
+      ImGui::Checkbox( "Auto-scroll", &g_bConsoleAutoScroll );
+
+      const uint64_t uiNumDropped{ rumDebugVM::GetNumDroppedLogMessages() };
+      if( uiNumDropped > 0 )
+      {
+        ImGui::SameLine();
+        ImGui::TextColored( { 1.0f, 0.4f, 0.4f, 1.0f }, "%llu messages dropped",
+                            static_cast<unsigned long long>( uiNumDropped ) );
+      }
+
+      const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
+      const ImVec2 cSize{ 0.0f, std::max( 0.0f, vRegion.y - 2.0f ) };
+      ImGui::BeginChild( "ConsoleTabChild", cSize, false, ImGuiWindowFlags_HorizontalScrollbar );
+
+      // Only the visible lines are submitted, so the console stays cheap no matter how much has been logged
+      const char* strBuffer{ g_cConsoleBuffer.begin() };
+      const char* strBufferEnd{ g_cConsoleBuffer.end() };
+
+      ImGuiListClipper cClipper;
+      cClipper.Begin( g_vConsoleLineOffsets.Size );
+      while( cClipper.Step() )
+      {
+        for( int32_t iLine{ cClipper.DisplayStart }; iLine < cClipper.DisplayEnd; ++iLine )
+        {
+          // Lines end before the following line's newline
+          const char* strLineStart{ strBuffer + g_vConsoleLineOffsets[iLine] };
+          const char* strLineEnd{ iLine + 1 < g_vConsoleLineOffsets.Size
+                                  ? strBuffer + g_vConsoleLineOffsets[iLine + 1] - 1
+                                  : strBufferEnd - 1 };
+          ImGui::TextUnformatted( strLineStart, strLineEnd );
+        }
+      }
+
+      cClipper.End();
+
+      if( g_bConsoleAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY() )
+      {
+        ImGui::SetScrollHereY( 1.0f );
+      }
+
+      // ConsoleTabChild
+      ImGui::EndChild();
+
+      // ConsoleTabItem
+      ImGui::EndTabItem();
+    }
+  }
+
+
   void UpdateDisplayFolder( const std::string& i_strFolder,
                             std::filesystem::recursive_directory_iterator& i_rcIter,
                             std::filesystem::recursive_directory_iterator& i_rcIterEnd,
@@ -745,6 +1121,8 @@ namespace rumDebugInterface
 
   void UpdateFileExplorer()
   {
+    const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::FileExplorer ) );
+
     static char strCFilter[MAX_FILENAME_LENGTH];
 
     // Adds a text input field for filtering file and folder names
@@ -775,6 +1153,113 @@ namespace rumDebugInterface
   }
 
 
+  void UpdateFunctionBreakpoints()
+  {
+    ImGui::Separator();
+    ImGui::TextUnformatted( "Function breakpoints" );
+
+    constexpr int32_t iNumColumns{ 4 };
+    constexpr ImGuiTableFlags eTableFlags{ ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchProp |
+                                           ImGuiTableFlags_Borders | ImGuiTableFlags_NoSavedSettings };
+    if( ImGui::BeginTable( "FunctionBreakpointsTable", iNumColumns, eTableFlags ) )
+    {
+      rumDebugFunctionBreakpoint cRemovedBreakpoint;
+      bool bBreakpointRemoved{ false };
+
+      // Fetch by copy here because there is potential to modify the list during iteration
+      const auto cvBreakpoints{ rumDebugVM::GetFunctionBreakpointsCopy() };
+      for( const auto& iter : cvBreakpoints )
+      {
+        const std::string strName{ iter.GetQualifiedName() };
+        ImGui::PushID( strName.c_str() );
+
+        ImGui::TableNextRow();
+
+        // The breakpoint enabled/disabled status
+        ImGui::TableNextColumn();
+        ImGui::TableSetBgColor( ImGuiTableBgTarget_CellBg,
+                                iter.m_bEnabled ? g_uiEnabledBreakpointColor : g_uiDisabledBreakpointColor );
+        ImGui::TextUnformatted( " * " );
+        if( ImGui::IsItemHovered() )
+        {
+          if( ImGui::IsKeyPressed( ImGuiKey_F9 ) || ImGui::IsMouseDoubleClicked( ImGuiMouseButton_Left ) )
+          {
+            rumDebugVM::FunctionBreakpointToggle( iter );
+          }
+          else if( ImGui::IsKeyPressed( ImGuiKey_Delete ) )
+          {
+            // Schedule for removal since we're mid-iteration
+            cRemovedBreakpoint = iter;
+            bBreakpointRemoved = true;
+          }
+        }
+
+        // The function name
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted( strName.c_str() );
+
+        // The hit count to break on, which is applied when Enter is pressed
+        ImGui::TableNextColumn();
+
+        ImGui::PushItemWidth( ImGui::GetColumnWidth() );
+
+        int32_t iHitCount{ static_cast<int32_t>( iter.m_uiHitCount ) };
+        if( ImGui::InputInt( "##HitCount", &iHitCount, 0, 0, ImGuiInputTextFlags_EnterReturnsTrue ) )
+        {
+          rumDebugVM::FunctionBreakpointSetHitCount( iter, static_cast<uint32_t>( std::max( iHitCount, 0 ) ) );
+        }
+
+        if( ImGui::IsItemHovered() )
+        {
+          ImGui::SetTooltip( "Break on this call, or on every call if 0" );
+        }
+
+        ImGui::PopItemWidth();
+
+        // The number of calls so far
+        ImGui::TableNextColumn();
+        ImGui::Text( "%u hits", iter.m_pcNumHits->load( std::memory_order_relaxed ) );
+        ImGui::SameLine();
+        if( ImGui::SmallButton( "Reset" ) )
+        {
+          rumDebugVM::FunctionBreakpointResetHits( iter );
+        }
+
+        ImGui::PopID();
+      }
+
+      if( bBreakpointRemoved )
+      {
+        rumDebugVM::FunctionBreakpointRemove( cRemovedBreakpoint );
+      }
+
+      ImGui::TableNextRow();
+
+      static char strCNewFunction[MAX_FILENAME_LENGTH];
+
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted( "+" );
+
+      ImGui::TableNextColumn();
+
+      ImGui::PushItemWidth( ImGui::GetColumnWidth() );
+
+      if( ImGui::InputTextWithHint( "##NewFunctionBreakpoint", "Class::Function", strCNewFunction,
+                                    IM_ARRAYSIZE( strCNewFunction ), ImGuiInputTextFlags_EnterReturnsTrue ) )
+      {
+        rumDebugVM::FunctionBreakpointAdd( rumDebugFunctionBreakpoint( strCNewFunction ) );
+
+        memset( strCNewFunction, '\0', sizeof( char ) * MAX_FILENAME_LENGTH );
+      }
+
+      ImGui::PopItemWidth();
+
+      // FunctionBreakpointsTable
+      ImGui::EndTable();
+    }
+  }
+
+
   void UpdateLocalsTab()
   {
     auto pcContext{ rumDebugVM::GetCurrentDebugContext() };
@@ -785,6 +1270,8 @@ namespace rumDebugInterface
 
     if( ImGui::BeginTabItem( "Locals##TabItem" ) )
     {
+      const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::Locals ) );
+
       const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
       const ImVec2 cSize{ 0.0f, std::max( 0.0f, vRegion.y - 2.0f ) };
       ImGui::BeginChild( "LocalsTabChild", cSize, false, ImGuiWindowFlags_HorizontalScrollbar );
@@ -886,17 +1373,492 @@ namespace rumDebugInterface
   }
 
 
-  void UpdateSecondaryRow()
+  void UpdateProfilerFlameGraph( const rumDebugCallTree& i_rcCallTree )
   {
-    constexpr ImGuiTableFlags eTableFlags{ ImGuiTableFlags_Resizable | ImGuiTableFlags_Borders |
-                                           ImGuiTableFlags_ScrollY };
-    constexpr int32_t iNumColumns{ 2 };
-    if( ImGui::BeginTable( "SecondaryRow", iNumColumns, eTableFlags ) )
+    // The frame the graph is zoomed in on, or the root
+    static uint32_t uiZoomNode{ 0 };
+
+    const auto& rcvNodes{ i_rcCallTree.m_vNodes };
+    if( uiZoomNode >= rcvNodes.size() )
     {
-      ImGui::TableNextRow();
+      // The call tree was reset
+      uiZoomNode = 0;
+    }
 
-      ImGui::TableNextColumn();
-      UpdateWatchLocalWindow();
+    if( uiZoomNode != 0 )
+    {
+      if( ImGui::SmallButton( "Reset Zoom" ) )
+      {
+        uiZoomNode = 0;
+      }
+
+      ImGui::SameLine();
+    }
+
+    ImGui::TextDisabled( "Double-click a frame to zoom in on it" );
+
+    const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
+    const ImVec2 cSize{ 0.0f, std::max( 0.0f, vRegion.y - 2.0f ) };
+    ImGui::BeginChild( "FlameGraphChild", cSize, false );
+
+    struct FlameFrame
+    {
+      uint32_t m_uiNode{ 0 };
+      uint32_t m_uiDepth{ 0 };
+      float m_fX{ 0.0f };
+    };
+
+    static std::vector<FlameFrame> vFrames;
+    vFrames.clear();
+
+    // The zoomed frame spans the full width, otherwise the root's children share it
+    int64_t iTotalNS{ 0 };
+    if( uiZoomNode != 0 )
+    {
+      iTotalNS = rcvNodes[uiZoomNode].m_iInclusiveNS;
+      vFrames.push_back( { uiZoomNode, 0, 0.0f } );
+    }
+    else
+    {
+      for( uint32_t uiChild{ rcvNodes[0].m_uiFirstChild }; uiChild != rumDebugCallTree::s_uiInvalidIndex;
+           uiChild = rcvNodes[uiChild].m_uiNextSibling )
+      {
+        iTotalNS += rcvNodes[uiChild].m_iInclusiveNS;
+      }
+
+      float fX{ 0.0f };
+      for( uint32_t uiChild{ rcvNodes[0].m_uiFirstChild }; uiChild != rumDebugCallTree::s_uiInvalidIndex;
+           uiChild = rcvNodes[uiChild].m_uiNextSibling )
+      {
+        vFrames.push_back( { uiChild, 0, fX } );
+        fX += static_cast<float>( rcvNodes[uiChild].m_iInclusiveNS );
+      }
+    }
+
+    const ImVec2 vOrigin{ ImGui::GetCursorScreenPos() };
+    const float fWidth{ ImGui::GetContentRegionAvail().x };
+    const float fRowHeight{ ImGui::GetFrameHeight() };
+    const float fScale{ iTotalNS > 0 ? fWidth / static_cast<float>( iTotalNS ) : 0.0f };
+
+    // Child positions are kept in nanoseconds until drawn so that they stay exact when zoomed
+    for( auto& iter : vFrames )
+    {
+      iter.m_fX *= fScale;
+    }
+
+    ImDrawList* pcDrawList{ ImGui::GetWindowDrawList() };
+    const bool bWindowHovered{ ImGui::IsWindowHovered() };
+
+    uint32_t uiMaxDepth{ 0 };
+    while( !vFrames.empty() )
+    {
+      const FlameFrame cFrame{ vFrames.back() };
+      vFrames.pop_back();
+
+      const rumDebugCallTree::Node& rcNode{ rcvNodes[cFrame.m_uiNode] };
+      const float fFrameWidth{ static_cast<float>( rcNode.m_iInclusiveNS ) * fScale };
+      if( fFrameWidth < 1.0f )
+      {
+        // Too narrow to see, and so are all of its children
+        continue;
+      }
+
+      uiMaxDepth = std::max( uiMaxDepth, cFrame.m_uiDepth );
+
+      const ImVec2 vMin{ vOrigin.x + cFrame.m_fX, vOrigin.y + cFrame.m_uiDepth * fRowHeight };
+      const ImVec2 vMax{ vMin.x + fFrameWidth - 1.0f, vMin.y + fRowHeight - 1.0f };
+
+      // Color by function so that the same function is recognizable throughout the graph
+      const float fHue{ static_cast<float>( ( rcNode.m_uiFunction * 2654435761U ) % 1000U ) / 1000.0f };
+      pcDrawList->AddRectFilled( vMin, vMax, ImColor::HSV( 0.12f * fHue, 0.65f, 0.9f ) );
+
+      const rumDebugProfileFunction& rcFunction{ i_rcCallTree.m_vFunctions[rcNode.m_uiFunction] };
+      const char* strName{ rcFunction.m_strFunction.empty() ? "(anonymous)" : rcFunction.m_strFunction.c_str() };
+
+      pcDrawList->PushClipRect( vMin, vMax, true );
+      pcDrawList->AddText( { vMin.x + 3.0f, vMin.y + ImGui::GetStyle().FramePadding.y }, IM_COL32_BLACK, strName );
+      pcDrawList->PopClipRect();
+
+      if( bWindowHovered && ImGui::IsMouseHoveringRect( vMin, vMax ) )
+      {
+        const char* strCountLabel{ rumDebugProfileSource::Sampled == g_eProfileSource ? "Samples" : "Calls" };
+        ImGui::SetTooltip( "%s\n%s:%d\nInclusive: %.3f ms (%.1f%%)\nExclusive: %.3f ms\n%s: %llu", strName,
+                           rcFunction.m_strSource.c_str(), rcFunction.m_iLine, rcNode.m_iInclusiveNS / 1.0e6,
+                           100.0 * rcNode.m_iInclusiveNS / iTotalNS, rcNode.m_iExclusiveNS / 1.0e6, strCountLabel,
+                           static_cast<unsigned long long>( rcNode.m_uiNumCalls ) );
+
+        if( ImGui::IsMouseDoubleClicked( ImGuiMouseButton_Left ) )
+        {
+          uiZoomNode = cFrame.m_uiNode;
+        }
+      }
+
+      float fChildX{ cFrame.m_fX };
+      for( uint32_t uiChild{ rcNode.m_uiFirstChild }; uiChild != rumDebugCallTree::s_uiInvalidIndex;
+           uiChild = rcvNodes[uiChild].m_uiNextSibling )
+      {
+        vFrames.push_back( { uiChild, cFrame.m_uiDepth + 1, fChildX } );
+        fChildX += static_cast<float>( rcvNodes[uiChild].m_iInclusiveNS ) * fScale;
+      }
+    }
+
+    // Reserve the graph's area so that deep graphs can be scrolled
+    ImGui::Dummy( { fWidth, ( uiMaxDepth + 1 ) * fRowHeight } );
+
+    // FlameGraphChild
+    ImGui::EndChild();
+  }
+
+
+  void UpdateProfilerFunctions( const std::shared_ptr<const rumDebugCallTree>& i_pcCallTree )
+  {
+    struct ProfiledFunction
+    {
+      uint32_t m_uiFunction{ 0 };
+      uint64_t m_uiNumCalls{ 0 };
+      int64_t m_iInclusiveNS{ 0 };
+      int64_t m_iExclusiveNS{ 0 };
+    };
+
+    // Per-function totals, only recalculated when a new call tree is published
+    static std::shared_ptr<const rumDebugCallTree> pcSummarizedCallTree;
+    static std::vector<ProfiledFunction> vFunctions;
+    static bool bSortFunctions{ false };
+
+    const rumDebugCallTree& rcCallTree{ *i_pcCallTree };
+    const auto& rcvNodes{ rcCallTree.m_vNodes };
+
+    if( pcSummarizedCallTree != i_pcCallTree )
+    {
+      pcSummarizedCallTree = i_pcCallTree;
+
+      std::vector<ProfiledFunction> vTotals( rcCallTree.m_vFunctions.size() );
+      for( size_t i{ 1 }; i < rcvNodes.size(); ++i )
+      {
+        const rumDebugCallTree::Node& rcNode{ rcvNodes[i] };
+
+        ProfiledFunction& rcTotal{ vTotals[rcNode.m_uiFunction] };
+        rcTotal.m_uiNumCalls += rcNode.m_uiNumCalls;
+        rcTotal.m_iExclusiveNS += rcNode.m_iExclusiveNS;
+
+        // A recursive call's time is already part of the inclusive time of the call that recursed
+        bool bRecursive{ false };
+        for( uint32_t uiParent{ rcNode.m_uiParent }; uiParent != 0 && !bRecursive;
+             uiParent = rcvNodes[uiParent].m_uiParent )
+        {
+          bRecursive = ( rcvNodes[uiParent].m_uiFunction == rcNode.m_uiFunction );
+        }
+
+        if( !bRecursive )
+        {
+          rcTotal.m_iInclusiveNS += rcNode.m_iInclusiveNS;
+        }
+      }
+
+      vFunctions.clear();
+      for( size_t i{ 0 }; i < vTotals.size(); ++i )
+      {
+        if( vTotals[i].m_uiNumCalls > 0 || vTotals[i].m_iInclusiveNS > 0 )
+        {
+          vTotals[i].m_uiFunction = static_cast<uint32_t>( i );
+          vFunctions.push_back( vTotals[i] );
+        }
+      }
+
+      bSortFunctions = true;
+    }
+
+    constexpr ImGuiTableFlags eTableFlags{ ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchProp |
+                                           ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY |
+                                           ImGuiTableFlags_Sortable | ImGuiTableFlags_NoSavedSettings };
+    constexpr int32_t iNumColumns{ 6 };
+    if( ImGui::BeginTable( "ProfilerFunctionsTable", iNumColumns, eTableFlags ) )
+    {
+      // Samples only count where execution was, so sampled functions have no call counts or averages
+      const bool bSampled{ rumDebugProfileSource::Sampled == g_eProfileSource };
+
+      constexpr ImGuiTableColumnFlags eNumberFlags{ ImGuiTableColumnFlags_PreferSortDescending };
+
+      ImGui::TableSetupScrollFreeze( 0, 1 );
+      ImGui::TableSetupColumn( "Function" );
+      ImGui::TableSetupColumn( bSampled ? "Samples" : "Calls", eNumberFlags );
+      ImGui::TableSetupColumn( "Inclusive (ms)", eNumberFlags );
+      ImGui::TableSetupColumn( "Exclusive (ms)", eNumberFlags | ImGuiTableColumnFlags_DefaultSort );
+      ImGui::TableSetupColumn( "Average (us)", eNumberFlags );
+      ImGui::TableSetupColumn( "Source" );
+      ImGui::TableHeadersRow();
+
+      ImGuiTableSortSpecs* pcSortSpecs{ ImGui::TableGetSortSpecs() };
+      if( pcSortSpecs && pcSortSpecs->SpecsCount > 0 && ( pcSortSpecs->SpecsDirty || bSortFunctions ) )
+      {
+        const ImGuiTableColumnSortSpecs& rcSpecs{ pcSortSpecs->Specs[0] };
+        const bool bAscending{ rcSpecs.SortDirection == ImGuiSortDirection_Ascending };
+
+        const auto GetAverageNS{ []( const ProfiledFunction& i_rcFunction ) -> int64_t
+        {
+          const auto iNumCalls{ static_cast<int64_t>( i_rcFunction.m_uiNumCalls ) };
+          return iNumCalls ? i_rcFunction.m_iInclusiveNS / iNumCalls : 0;
+        } };
+
+        std::stable_sort( vFunctions.begin(), vFunctions.end(),
+                          [&]( const ProfiledFunction& i_rcLeft, const ProfiledFunction& i_rcRight )
+                          {
+                            const ProfiledFunction& rcFirst{ bAscending ? i_rcLeft : i_rcRight };
+                            const ProfiledFunction& rcSecond{ bAscending ? i_rcRight : i_rcLeft };
+
+                            const auto& rcFirstFunction{ rcCallTree.m_vFunctions[rcFirst.m_uiFunction] };
+                            const auto& rcSecondFunction{ rcCallTree.m_vFunctions[rcSecond.m_uiFunction] };
+
+                            switch( rcSpecs.ColumnIndex )
+                            {
+                              case 0: return rcFirstFunction.m_strFunction < rcSecondFunction.m_strFunction;
+                              case 1: return rcFirst.m_uiNumCalls < rcSecond.m_uiNumCalls;
+                              case 2: return rcFirst.m_iInclusiveNS < rcSecond.m_iInclusiveNS;
+                              case 3: return rcFirst.m_iExclusiveNS < rcSecond.m_iExclusiveNS;
+                              case 4: return GetAverageNS( rcFirst ) < GetAverageNS( rcSecond );
+                              default: return rcFirstFunction.m_strSource < rcSecondFunction.m_strSource;
+                            }
+                          } );
+
+        pcSortSpecs->SpecsDirty = false;
+        bSortFunctions = false;
+      }
+
+      ImGuiListClipper cClipper;
+      cClipper.Begin( static_cast<int32_t>( vFunctions.size() ) );
+      while( cClipper.Step() )
+      {
+        for( int32_t iRow{ cClipper.DisplayStart }; iRow < cClipper.DisplayEnd; ++iRow )
+        {
+          const ProfiledFunction& rcTotal{ vFunctions[iRow] };
+          const rumDebugProfileFunction& rcFunction{ rcCallTree.m_vFunctions[rcTotal.m_uiFunction] };
+
+          ImGui::TableNextRow();
+
+          ImGui::TableNextColumn();
+          ImGui::TextUnformatted( rcFunction.m_strFunction.empty() ? "(anonymous)"
+                                                                   : rcFunction.m_strFunction.c_str() );
+
+          ImGui::TableNextColumn();
+          ImGui::Text( "%llu", static_cast<unsigned long long>( rcTotal.m_uiNumCalls ) );
+
+          ImGui::TableNextColumn();
+          ImGui::Text( "%.3f", rcTotal.m_iInclusiveNS / 1.0e6 );
+
+          ImGui::TableNextColumn();
+          ImGui::Text( "%.3f", rcTotal.m_iExclusiveNS / 1.0e6 );
+
+          ImGui::TableNextColumn();
+          if( !bSampled && rcTotal.m_uiNumCalls > 0 )
+          {
+            ImGui::Text( "%.3f", rcTotal.m_iInclusiveNS / 1.0e3 / rcTotal.m_uiNumCalls );
+          }
+
+          // The function's source and first line
+          ImGui::TableNextColumn();
+          const std::filesystem::path fsSource{ rcFunction.m_strSource };
+          ImGui::Text( "%s:%d", fsSource.filename().generic_string().c_str(), rcFunction.m_iLine );
+          if( ImGui::IsItemHovered() )
+          {
+            ImGui::SetTooltip( rcFunction.m_strSource.c_str() );
+
+            if( ImGui::IsMouseDoubleClicked( ImGuiMouseButton_Left ) )
+            {
+              rumDebugVM::FileOpen( fsSource, static_cast<uint32_t>( rcFunction.m_iLine ) );
+            }
+          }
+        }
+      }
+
+      cClipper.End();
+
+      // ProfilerFunctionsTable
+      ImGui::EndTable();
+    }
+  }
+
+
+  void UpdateProfilerTab()
+  {
+    if( ImGui::BeginTabItem( "Profiler##TabItem" ) )
+    {
+      const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::Profiler ) );
+
+      // The VM whose call timings are shown
+      static std::string strProfiledVM;
+
+      const auto& cDebugContexts{ rumDebugVM::GetDebugContexts() };
+      if( strProfiledVM.empty() && !cDebugContexts.empty() )
+      {
+        strProfiledVM = cDebugContexts.front().m_strName;
+      }
+
+      ImGui::SetNextItemWidth( ImGui::GetFontSize() * 12.0f );
+      if( ImGui::BeginCombo( "VM##ProfiledVM", strProfiledVM.c_str() ) )
+      {
+        for( const auto& iter : cDebugContexts )
+        {
+          if( ImGui::Selectable( iter.m_strName.c_str(), iter.m_strName.compare( strProfiledVM ) == 0 ) )
+          {
+            strProfiledVM = iter.m_strName;
+          }
+        }
+
+        ImGui::EndCombo();
+      }
+
+      ImGui::SameLine();
+      if( ImGui::RadioButton( "Timed Calls", rumDebugProfileSource::Instrumented == g_eProfileSource ) )
+      {
+        g_eProfileSource = rumDebugProfileSource::Instrumented;
+      }
+
+      ImGui::SameLine();
+      if( ImGui::RadioButton( "Samples", rumDebugProfileSource::Sampled == g_eProfileSource ) )
+      {
+        g_eProfileSource = rumDebugProfileSource::Sampled;
+      }
+
+      const bool bSampled{ rumDebugProfileSource::Sampled == g_eProfileSource };
+      if( bSampled )
+      {
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth( ImGui::GetFontSize() * 6.0f );
+        int32_t iSampleRate{ static_cast<int32_t>( rumDebugVM::GetSampleRate() ) };
+        if( ImGui::InputInt( "Hz##SampleRate", &iSampleRate, 100, 1000, ImGuiInputTextFlags_EnterReturnsTrue ) )
+        {
+          rumDebugVM::SetSampleRate( static_cast<uint32_t>( std::max( iSampleRate, 0 ) ) );
+        }
+
+        const uint64_t uiNumDropped{ rumDebugVM::GetNumDroppedSamples( strProfiledVM ) };
+        if( uiNumDropped > 0 )
+        {
+          ImGui::SameLine();
+          ImGui::TextDisabled( "(%llu samples dropped)", static_cast<unsigned long long>( uiNumDropped ) );
+        }
+      }
+
+      // Exports for external tools. Traces and coverage cover every VM, while collapsed stacks are written from the
+      // call tree shown below.
+      static char strCTracePath[MAX_FILENAME_LENGTH]{ "profile.trace.json" };
+      static char strCCollapsedStacksPath[MAX_FILENAME_LENGTH]{ "profile.folded" };
+      static char strCCoveragePath[MAX_FILENAME_LENGTH]{ "coverage.info" };
+
+      const float fPathWidth{ ImGui::GetFontSize() * 16.0f };
+      const bool bTracing{ rumDebugVM::IsTracing() };
+
+      ImGui::BeginDisabled( bTracing );
+      ImGui::SetNextItemWidth( fPathWidth );
+      ImGui::InputText( "##TracePath", strCTracePath, IM_ARRAYSIZE( strCTracePath ) );
+      ImGui::EndDisabled();
+
+      ImGui::SameLine();
+      if( bTracing )
+      {
+        if( ImGui::Button( "Stop Recording" ) )
+        {
+          rumDebugVM::TraceStop();
+        }
+
+        const uint64_t uiNumDropped{ rumDebugVM::GetNumDroppedTraceEvents() };
+        if( uiNumDropped > 0 )
+        {
+          ImGui::SameLine();
+          ImGui::TextDisabled( "(%llu events dropped)", static_cast<unsigned long long>( uiNumDropped ) );
+        }
+      }
+      else if( ImGui::Button( "Record Trace" ) )
+      {
+        rumDebugVM::TraceStart( strCTracePath );
+      }
+
+      if( ImGui::IsItemHovered() )
+      {
+        ImGui::SetTooltip( "Records calls, samples, and pauses of every attached VM as Chrome trace JSON, which can be "
+                           "opened in Perfetto" );
+      }
+
+      ImGui::SetNextItemWidth( fPathWidth );
+      ImGui::InputText( "##CollapsedStacksPath", strCCollapsedStacksPath,
+                        IM_ARRAYSIZE( strCCollapsedStacksPath ) );
+
+      ImGui::SameLine();
+      if( ImGui::Button( "Export Collapsed Stacks" ) )
+      {
+        rumDebugVM::ExportCollapsedStacks( strProfiledVM, g_eProfileSource, strCCollapsedStacksPath );
+      }
+
+      if( ImGui::IsItemHovered() )
+      {
+        ImGui::SetTooltip( "Writes the call tree below in the collapsed stack format read by flame graph tools" );
+      }
+
+      ImGui::SetNextItemWidth( fPathWidth );
+      ImGui::InputText( "##CoveragePath", strCCoveragePath, IM_ARRAYSIZE( strCCoveragePath ) );
+
+      ImGui::SameLine();
+      if( ImGui::Button( "Export Coverage" ) )
+      {
+        rumDebugVM::ExportLineCoverage( strCCoveragePath );
+      }
+
+      if( ImGui::IsItemHovered() )
+      {
+        ImGui::SetTooltip( "Writes the lines covered by every VM as an lcov tracefile. Start covering lines from the "
+                           "VMs tab." );
+      }
+
+      const std::string strExportError{ rumDebugVM::GetLastExportError() };
+      if( !strExportError.empty() )
+      {
+        ImGui::TextColored( { 1.0f, 0.4f, 0.4f, 1.0f }, "%s", strExportError.c_str() );
+      }
+
+      const auto pcCallTree{ rumDebugVM::GetCallTree( strProfiledVM, g_eProfileSource ) };
+      if( !pcCallTree || pcCallTree->m_vNodes.size() <= 1 )
+      {
+        ImGui::TextUnformatted( bSampled ? "No samples taken. Start sampling from the VMs tab."
+                                         : "No calls timed. Start timing calls from the VMs tab." );
+      }
+      else if( ImGui::BeginTabBar( "ProfilerViewsTabBar", ImGuiTabBarFlags_None ) )
+      {
+        if( ImGui::BeginTabItem( "Functions##TabItem" ) )
+        {
+          UpdateProfilerFunctions( pcCallTree );
+
+          // FunctionsTabItem
+          ImGui::EndTabItem();
+        }
+
+        if( ImGui::BeginTabItem( "Flame Graph##TabItem" ) )
+        {
+          UpdateProfilerFlameGraph( *pcCallTree );
+
+          // FlameGraphTabItem
+          ImGui::EndTabItem();
+        }
+
+        // ProfilerViewsTabBar
+        ImGui::EndTabBar();
+      }
+
+      // ProfilerTabItem
+      ImGui::EndTabItem();
+    }
+  }
+
+
+  void UpdateSecondaryRow()
+  {
+    constexpr ImGuiTableFlags eTableFlags{ ImGuiTableFlags_Resizable | ImGuiTableFlags_Borders |
+                                           ImGuiTableFlags_ScrollY };
+    constexpr int32_t iNumColumns{ 2 };
+    if( ImGui::BeginTable( "SecondaryRow", iNumColumns, eTableFlags ) )
+    {
+      ImGui::TableNextRow();
+
+      ImGui::TableNextColumn();
+      UpdateWatchLocalWindow();
 
       ImGui::TableNextColumn();
       UpdateStackBreakpointWindow();
@@ -937,6 +1899,8 @@ namespace rumDebugInterface
 
   void UpdateSourceCode()
   {
+    const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::SourceCode ) );
+
     static ImU32 uiCurrentLineColor{ ImGui::GetColorU32( { 0.2f, 0.4f, 0.7f, 0.5f } ) };
     static const ImU32 uiFindTextLineColor{ ImGui::GetColorU32( { 1.0f, 1.0f, 0.0f, 0.5f } ) };
 
@@ -1043,15 +2007,30 @@ namespace rumDebugInterface
             }
           }
 
+          // Executed line counts from the line profiler or sample counts from the sampler, indexed by line. The heat
+          // gutter is only shown for files with counted lines.
+          static std::vector<uint32_t> vLineCounts;
+          const uint32_t uiMaxLineCount{ rumDebugVM::GetLineCounts( rcFile.m_fsFilePath, g_eProfileSource,
+                                                                    vLineCounts ) };
+          const bool bShowHeat{ uiMaxLineCount > 0 };
+
+          // Covered lines from every VM, indexed by line. Coverage shading is only shown for files with covered lines.
+          static std::vector<uint64_t> vCoveredLines;
+          const bool bShowCoverage{ rumDebugVM::GetLineCoverage( rcFile.m_fsFilePath, vCoveredLines ) };
+
           constexpr ImGuiTableFlags eTableFlags{ ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_Resizable |
                                                  ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY |
                                                  ImGuiTableFlags_NoSavedSettings };
-          constexpr int32_t iNumColumns{ 2 };
+          const int32_t iNumColumns{ bShowHeat ? 3 : 2 };
           if( ImGui::BeginTable( "SourceCode", iNumColumns, eTableFlags ) )
           {
             ImGui::TableSetupColumn( "Line", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 3.0f );
+            if( bShowHeat )
+            {
+              ImGui::TableSetupColumn( "Heat", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 4.0f );
+            }
             ImGui::TableSetupColumn( "Source", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * rcFile.m_uiLongestLine );
-            ImGui::TableSetupScrollFreeze( 1, 0 );
+            ImGui::TableSetupScrollFreeze( bShowHeat ? 2 : 1, 0 );
 
             const int32_t iNumLines{ static_cast<int32_t>( rcFile.m_vStringOffsets.size() ) };
             const bool bHasFocus{ ImGui::IsWindowFocused( ImGuiFocusedFlags_ChildWindows ) };
@@ -1194,14 +2173,17 @@ namespace rumDebugInterface
               for( int32_t iRow{ cClipper.DisplayStart }; iRow < cClipper.DisplayEnd; ++iRow )
               {
                 bool bInMultilineComment{ false };
+                bool bInCoverageComment{ false };
                 int32_t iLine{ iRow + 1 };
 
-                // Determine if this line is inside of a multiline comment
+                // Determine if this line is inside of a multiline comment. For coverage, a line that continues a
+                // comment is judged from the comment state at its start.
                 for( const auto& commentIter : rcFile.m_vMultilineComments )
                 {
-                  if( iLine > commentIter.m_iStartLine && iLine < commentIter.m_iEndLine )
+                  if( iLine > commentIter.m_iStartLine && iLine <= commentIter.m_iEndLine )
                   {
-                    bInMultilineComment = true;
+                    bInMultilineComment = iLine < commentIter.m_iEndLine;
+                    bInCoverageComment = true;
                     break;
                   }
                 }
@@ -1242,6 +2224,30 @@ namespace rumDebugInterface
                   }
                 }
 
+                if( bShowHeat )
+                {
+                  // The heat gutter column, shaded on a log scale relative to the most executed line in the file
+                  ImGui::TableNextColumn();
+
+                  const uint32_t uiCount{ static_cast<size_t>( iLine ) < vLineCounts.size() ? vLineCounts[iLine] : 0 };
+                  if( uiCount > 0 )
+                  {
+                    const float fHeat{ std::log( 1.0f + uiCount ) / std::log( 1.0f + uiMaxLineCount ) };
+                    ImGui::TableSetBgColor( ImGuiTableBgTarget_CellBg,
+                                            ImGui::GetColorU32( { 1.0f, 0.6f * ( 1.0f - fHeat ), 0.0f,
+                                                                  0.2f + 0.6f * fHeat } ) );
+                    ImGui::Text( "%u", uiCount );
+
+                    if( ImGui::IsItemHovered() )
+                    {
+                      ImGui::SetTooltip( rumDebugProfileSource::Sampled == g_eProfileSource
+                                           ? "Sampled %u times (%.1f%% of the hottest line)"
+                                           : "Executed %u times (%.1f%% of the hottest line)",
+                                         uiCount, 100.0 * uiCount / uiMaxLineCount );
+                    }
+                  }
+                }
+
                 // The source code column
                 ImGui::TableNextColumn();
 
@@ -1251,6 +2257,21 @@ namespace rumDebugInterface
                   size_t iEnd{ rcFile.m_vStringOffsets[iRow + 1] - 1 };
                   std::string strLine{ rcFile.m_strData.substr( iBegin, iEnd - iBegin ) };
 
+                  if( bShowCoverage )
+                  {
+                    // Shade covered lines, and lines that look executable but haven't been covered
+                    if( rumDebugLineCoverage::IsLineCovered( vCoveredLines, static_cast<uint32_t>( iLine ) ) )
+                    {
+                      ImGui::TableSetBgColor( ImGuiTableBgTarget_CellBg,
+                                              ImGui::GetColorU32( { 0.2f, 0.8f, 0.2f, 0.15f } ) );
+                    }
+                    else if( rumDebugUtility::IsExecutableLine( strLine, bInCoverageComment ) )
+                    {
+                      ImGui::TableSetBgColor( ImGuiTableBgTarget_CellBg,
+                                              ImGui::GetColorU32( { 0.9f, 0.2f, 0.2f, 0.15f } ) );
+                    }
+                  }
+
                   const auto pcContext{ rumDebugVM::GetCurrentDebugContext() };
                   if( pcContext && pcContext->m_bPaused &&
                       ( pcContext->m_uiPausedLine == static_cast<uint32_t>( iLine ) ) &&
@@ -1334,6 +2355,8 @@ namespace rumDebugInterface
     {
       UpdateStackTab();
       UpdateBreakpointTab();
+      UpdateConsoleTab();
+      UpdateProfilerTab();
       UpdateVMsTab();
 
       // StackAndBreakpointsTabBar
@@ -1349,6 +2372,8 @@ namespace rumDebugInterface
   {
     if( ImGui::BeginTabItem( "Callstack##TabItem" ) )
     {
+      const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::Callstack ) );
+
       const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
       const ImVec2 cSize{ 0.0f, std::max( 0.0f, vRegion.y - 2.0f ) };
 
@@ -1418,6 +2443,110 @@ namespace rumDebugInterface
   }
 
 
+  void UpdateStatsWindow()
+  {
+    ImGui::SetNextWindowSize( { ImGui::GetFontSize() * 28.0f, ImGui::GetFontSize() * 30.0f }, ImGuiCond_FirstUseEver );
+
+    if( ImGui::Begin( "Debugger Stats", &g_bShowStats ) )
+    {
+      const rumDebugStats cStats{ rumDebugVM::GetStats() };
+
+      if( ImGui::SmallButton( "Reset" ) )
+      {
+        rumDebugVM::StatsReset();
+        RequestPanelTimingsReset();
+      }
+
+      ImGui::SameLine();
+      bool bHookTiming{ rumDebugVM::IsHookTimingEnabled() };
+      if( ImGui::Checkbox( "Time Debug Hook", &bHookTiming ) )
+      {
+        rumDebugVM::SetHookTimingEnabled( bHookTiming );
+      }
+
+      if( ImGui::IsItemHovered() )
+      {
+        ImGui::SetTooltip( "Measures time spent in the debug hook, which adds two clock reads to every hook event" );
+      }
+
+      constexpr ImGuiTableFlags eTableFlags{ ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                             ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_NoSavedSettings };
+
+      const auto AddRow{ []( const char* i_strName, const char* i_strFormat, auto... i_Args )
+      {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted( i_strName );
+        ImGui::TableNextColumn();
+        ImGui::Text( i_strFormat, i_Args... );
+      } };
+
+      constexpr double fNSPerMS{ 1000000.0 };
+
+      if( ImGui::BeginTable( "VMStatsTable", 2, eTableFlags ) )
+      {
+        ImGui::TableSetupColumn( "VM Overhead" );
+        ImGui::TableSetupColumn( "Total" );
+        ImGui::TableHeadersRow();
+
+        const uint64_t uiNumHookEvents{ cStats.m_uiNumCallEvents + cStats.m_uiNumReturnEvents +
+                                        cStats.m_uiNumLineEvents };
+
+        AddRow( "Call events", "%llu", static_cast<unsigned long long>( cStats.m_uiNumCallEvents ) );
+        AddRow( "Return events", "%llu", static_cast<unsigned long long>( cStats.m_uiNumReturnEvents ) );
+        AddRow( "Line events", "%llu", static_cast<unsigned long long>( cStats.m_uiNumLineEvents ) );
+
+        if( bHookTiming || cStats.m_uiHookNS > 0 )
+        {
+          AddRow( "Hook time", "%.3f ms (%.1f ns per event)", cStats.m_uiHookNS / fNSPerMS,
+                  uiNumHookEvents > 0 ? static_cast<double>( cStats.m_uiHookNS ) / uiNumHookEvents : 0.0 );
+        }
+        else
+        {
+          AddRow( "Hook time", "%s", "(not timed)" );
+        }
+
+        AddRow( "Breakpoint checks", "%llu", static_cast<unsigned long long>( cStats.m_uiNumBreakpointChecks ) );
+        AddRow( "Pauses", "%llu (%.3f ms)", static_cast<unsigned long long>( cStats.m_uiNumPauses ),
+                cStats.m_uiPausedNS / fNSPerMS );
+        AddRow( "Formatted variables", "%llu (%.3f ms)",
+                static_cast<unsigned long long>( cStats.m_uiNumFormattedVariables ), cStats.m_uiFormatNS / fNSPerMS );
+        AddRow( "Reused variables", "%llu", static_cast<unsigned long long>( cStats.m_uiNumReusedVariables ) );
+        AddRow( "Cached files", "%llu (%.1f KB)", static_cast<unsigned long long>( cStats.m_uiNumCachedFiles ),
+                cStats.m_uiCachedFileBytes / 1024.0 );
+
+        // VMStatsTable
+        ImGui::EndTable();
+      }
+
+      if( ImGui::BeginTable( "PanelStatsTable", 3, eTableFlags ) )
+      {
+        ImGui::TableSetupColumn( "Interface Panel" );
+        ImGui::TableSetupColumn( "Last (ms)" );
+        ImGui::TableSetupColumn( "Average (ms)" );
+        ImGui::TableHeadersRow();
+
+        for( const auto& iter : GetPanelTimings() )
+        {
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::TextUnformatted( iter.m_strName );
+          ImGui::TableNextColumn();
+          ImGui::Text( "%.3f", iter.m_uiLastNS / fNSPerMS );
+          ImGui::TableNextColumn();
+          ImGui::Text( "%.3f", iter.m_uiAverageNS / fNSPerMS );
+        }
+
+        // PanelStatsTable
+        ImGui::EndTable();
+      }
+    }
+
+    // Debugger Stats window
+    ImGui::End();
+  }
+
+
   void UpdateWatchLocalWindow()
   {
     const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
@@ -1450,6 +2579,15 @@ namespace rumDebugInterface
   {
     if( ImGui::BeginTabItem( "VMs##TabItem" ) )
     {
+      const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::VMs ) );
+
+      ImGui::Checkbox( "Show Debugger Stats", &g_bShowStats );
+
+      if( ImGui::IsItemHovered() )
+      {
+        ImGui::SetTooltip( "Shows what the debugger itself costs in hook time, pauses, and interface frame time" );
+      }
+
       const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
       const ImVec2 cSize{ 0.0f, std::max( 0.0f, vRegion.y - 2.0f ) };
       ImGui::BeginChild( "VMsTabChild", cSize, false, ImGuiWindowFlags_HorizontalScrollbar );
@@ -1472,12 +2610,96 @@ namespace rumDebugInterface
 
           // VM State
           ImGui::TableNextColumn();
+          ImGui::PushID( iter.m_strName.c_str() );
           if( iter.m_bAttached )
           {
             if( ImGui::SmallButton( "Detach" ) )
             {
               rumDebugVM::RequestDetachVM( iter.m_strName );
             }
+
+            if( !iter.m_bPaused )
+            {
+              ImGui::SameLine();
+              if( ImGui::SmallButton( "Pause" ) )
+              {
+                rumDebugVM::RequestPauseVM( iter.m_strName );
+              }
+            }
+
+            ImGui::SameLine();
+            if( iter.m_bLineProfiling )
+            {
+              if( ImGui::SmallButton( "Stop Counting" ) )
+              {
+                rumDebugVM::LineProfilerStop( iter.m_strName );
+              }
+            }
+            else if( ImGui::SmallButton( "Count Lines" ) )
+            {
+              rumDebugVM::LineProfilerStart( iter.m_strName );
+            }
+
+            if( ImGui::IsItemHovered() )
+            {
+              ImGui::SetTooltip( "Counts executed lines, shown in the source code gutter" );
+            }
+
+            ImGui::SameLine();
+            if( iter.m_bFunctionProfiling )
+            {
+              if( ImGui::SmallButton( "Stop Timing" ) )
+              {
+                rumDebugVM::FunctionProfilerStop( iter.m_strName );
+              }
+            }
+            else if( ImGui::SmallButton( "Time Calls" ) )
+            {
+              rumDebugVM::FunctionProfilerStart( iter.m_strName );
+            }
+
+            if( ImGui::IsItemHovered() )
+            {
+              ImGui::SetTooltip( "Times script function calls, shown in the Profiler tab" );
+            }
+
+            ImGui::SameLine();
+            if( iter.m_bSampling )
+            {
+              if( ImGui::SmallButton( "Stop Sampling" ) )
+              {
+                rumDebugVM::SamplerStop( iter.m_strName );
+              }
+            }
+            else if( ImGui::SmallButton( "Sample" ) )
+            {
+              rumDebugVM::SamplerStart( iter.m_strName );
+            }
+
+            if( ImGui::IsItemHovered() )
+            {
+              ImGui::SetTooltip( "Periodically samples the executing line and call stack, with much less overhead "
+                                 "than counting lines or timing calls" );
+            }
+
+            ImGui::SameLine();
+            if( iter.m_bLineCoverage )
+            {
+              if( ImGui::SmallButton( "Stop Coverage" ) )
+              {
+                rumDebugVM::CoverageStop( iter.m_strName );
+              }
+            }
+            else if( ImGui::SmallButton( "Cover Lines" ) )
+            {
+              rumDebugVM::CoverageStart( iter.m_strName );
+            }
+
+            if( ImGui::IsItemHovered() )
+            {
+              ImGui::SetTooltip( "Marks executed lines as covered, shaded in the source code view and exported from "
+                                 "the Profiler tab" );
+            }
           }
           else
           {
@@ -1486,6 +2708,16 @@ namespace rumDebugInterface
               rumDebugVM::RequestAttachVM( iter.m_strName );
             }
           }
+
+          ImGui::SameLine();
+          if( ImGui::SmallButton( "Reset Profile" ) )
+          {
+            rumDebugVM::LineProfilerReset( iter.m_strName );
+            rumDebugVM::FunctionProfilerReset( iter.m_strName );
+            rumDebugVM::SamplerReset( iter.m_strName );
+            rumDebugVM::CoverageReset( iter.m_strName );
+          }
+          ImGui::PopID();
         }
 
         // VMsTable
@@ -1511,6 +2743,8 @@ namespace rumDebugInterface
 
     if( ImGui::BeginTabItem( "Watched##TabItem" ) )
     {
+      const rumDebugPanelTimer cPanelTimer( GetPanelCounters( rumDebugPanel::Watched ) );
+
       const ImVec2 vRegion{ ImGui::GetContentRegionAvail() };
       const ImVec2 cSize{ 0.0f, std::max( 0.0f, vRegion.y - 2.0f ) };
       ImGui::BeginChild( "WatchedTabChild", cSize, false, ImGuiWindowFlags_HorizontalScrollbar );
@@ -1523,7 +2757,7 @@ namespace rumDebugInterface
         constexpr int32_t iNumColumns{ 3 };
         if( ImGui::BeginTable( "WatchTable", iNumColumns, eTableFlags ) )
         {
-          static char strCWatchVariable[MAX_FILENAME_LENGTH];
+          static char strCWatchVariable[MAX_EXPRESSION_LENGTH];
 
           // Fetch by copy here because there is potential to modify the list during iteration
           // #TODO - There is a lot of data being copied - work out a threadsafe share
@@ -1535,10 +2769,19 @@ namespace rumDebugInterface
             // Watch variable name
             ImGui::TableNextColumn();
 
-            ImGui::PushItemWidth( ImGui::GetColumnWidth() );
+            std::string strContentID{ "##" + iter.m_strName };
+
+            // Containers get an expansion arrow ahead of the editable name
+            bool bOpen{ false };
+            if( iter.m_uiHandle != 0 )
+            {
+              bOpen = ImGui::TreeNodeEx( ( strContentID + "Expand" ).c_str(), ImGuiTreeNodeFlags_NoTreePushOnOpen );
+              ImGui::SameLine();
+            }
+
+            ImGui::PushItemWidth( ImGui::GetContentRegionAvail().x );
 
             strncpy_s( strCWatchVariable, iter.m_strName.c_str(), iter.m_strName.length() + 1 );
-            std::string strContentID{ "##" + iter.m_strName };
             if( ImGui::InputText( strContentID.c_str(), strCWatchVariable, IM_ARRAYSIZE( strCWatchVariable ),
                                   ImGuiInputTextFlags_EnterReturnsTrue ) )
             {
@@ -1576,23 +2819,19 @@ namespace rumDebugInterface
 
             // Watch variable value
             ImGui::TableNextColumn();
+            DisplayVariableValue( iter );
 
-            // Preview the results if there are more than 3 lines
-            const auto szOffset{ FindNthOccurrence( iter.m_strValue, "\n", NUM_VARIABLE_PREVIEW_LINES ) };
-            if( szOffset == std::string::npos )
-            {
-              ImGui::TextUnformatted( iter.m_strValue.c_str() );
-            }
-            else
+            if( bOpen )
             {
-              ImGui::TextUnformatted( iter.m_strValue.substr( 0, szOffset ).c_str() );
-              DoVariableExpansion( iter );
+              ImGui::TreePush( strContentID.c_str() );
+              DisplayVariableChildren( iter.m_uiHandle );
+              ImGui::TreePop();
             }
           }
 
           ImGui::TableNextRow();
 
-          static char strCNewWatchVariable[MAX_FILENAME_LENGTH];
+          static char strCNewWatchVariable[MAX_EXPRESSION_LENGTH];
 
           ImGui::TableNextColumn();
           ImGui::TextUnformatted( "+" );
@@ -1605,7 +2844,7 @@ namespace rumDebugInterface
           {
             rumDebugVM::WatchVariableAdd( strCNewWatchVariable );
 
-            memset( strCNewWatchVariable, '\0', sizeof( char ) * MAX_FILENAME_LENGTH );
+            memset( strCNewWatchVariable, '\0', sizeof( char ) * MAX_EXPRESSION_LENGTH );
           }
 
           ImGui::PopItemWidth();
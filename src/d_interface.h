@@ -1,7 +1,10 @@
 #pragma once
 
+#include <d_stats.h>
+
 #include <filesystem>
 #include <string>
+#include <vector>
 
 
 // The interactable ImGui interface by which users debug attached Squirrel VMs. Through this interface, users can
@@ -10,8 +13,14 @@
 
 namespace rumDebugInterface
 {
+  // Frame timings of the interface's panels, in rumDebugPanel order. Can be called from any thread.
+  std::vector<rumDebugPanelTiming> GetPanelTimings();
+
   void Init( const std::string& i_strName, uint32_t i_iPort, const std::string& i_strScriptPath );
 
+  // Starts the panel frame timings over. The timings are cleared at the start of the interface's next frame.
+  void RequestPanelTimingsReset();
+
   void RequestSettingsUpdate();
 
   void SetFileFocus( const std::filesystem::path& i_fsFocusFile, int32_t i_iFocusLine );
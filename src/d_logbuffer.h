@@ -0,0 +1,122 @@
+#pragma once
+
+#include <d_settings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+// A fixed-size, lock-free queue of logpoint messages. Any number of VM threads can push messages while the interface
+// thread drains them. Pushing never blocks or allocates - when every slot is in use, the message is dropped and
+// counted instead.
+
+struct rumDebugLogBuffer
+{
+  static constexpr size_t s_szNumSlots{ LOGPOINT_BUFFER_SLOTS };
+  static constexpr size_t s_szMessageLength{ LOGPOINT_MESSAGE_LENGTH };
+
+  static_assert( ( s_szNumSlots & ( s_szNumSlots - 1 ) ) == 0, "LOGPOINT_BUFFER_SLOTS must be a power of two" );
+
+  rumDebugLogBuffer()
+  {
+    for( size_t i{ 0 }; i < s_szNumSlots; ++i )
+    {
+      m_cSlots[i].m_uiSequence.store( i, std::memory_order_relaxed );
+    }
+  }
+
+  // Consumes all published messages in the order they were claimed, passing each to the callback. Only one thread may
+  // drain the buffer.
+  template<typename Callback>
+  size_t Drain( Callback&& i_rfnCallback )
+  {
+    size_t szNumDrained{ 0 };
+
+    for( ;; )
+    {
+      Slot& rcSlot{ m_cSlots[m_uiDequeuePosition & ( s_szNumSlots - 1 )] };
+      if( rcSlot.m_uiSequence.load( std::memory_order_acquire ) != m_uiDequeuePosition + 1 )
+      {
+        // The next message is either unclaimed or still being written
+        break;
+      }
+
+      i_rfnCallback( rcSlot.m_strMessage, static_cast<size_t>( rcSlot.m_uiLength ) );
+
+      // Hand the slot back to producers for use one lap later
+      rcSlot.m_uiSequence.store( m_uiDequeuePosition + s_szNumSlots, std::memory_order_release );
+      ++m_uiDequeuePosition;
+      ++szNumDrained;
+    }
+
+    return szNumDrained;
+  }
+
+  uint64_t GetNumDropped() const
+  {
+    return m_uiNumDropped.load( std::memory_order_relaxed );
+  }
+
+  // Formats a message into the next free slot, truncating it to the slot size. Returns false if the buffer was full.
+  bool Push( const char* i_strFormat, ... )
+  {
+    uint64_t uiPosition{ m_uiEnqueuePosition.load( std::memory_order_relaxed ) };
+
+    Slot* pcSlot{ nullptr };
+    for( ;; )
+    {
+      pcSlot = &m_cSlots[uiPosition & ( s_szNumSlots - 1 )];
+
+      const uint64_t uiSequence{ pcSlot->m_uiSequence.load( std::memory_order_acquire ) };
+      const int64_t iDifference{ static_cast<int64_t>( uiSequence - uiPosition ) };
+      if( 0 == iDifference )
+      {
+        // The slot is free for this lap, so try to claim it
+        if( m_uiEnqueuePosition.compare_exchange_weak( uiPosition, uiPosition + 1, std::memory_order_relaxed ) )
+        {
+          break;
+        }
+      }
+      else if( iDifference < 0 )
+      {
+        // The slot still holds a message from the previous lap that hasn't been drained
+        m_uiNumDropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+      }
+      else
+      {
+        // Another producer claimed the slot first
+        uiPosition = m_uiEnqueuePosition.load( std::memory_order_relaxed );
+      }
+    }
+
+    va_list args;
+    va_start( args, i_strFormat );
+    const int32_t iLength{ vsnprintf( pcSlot->m_strMessage, s_szMessageLength, i_strFormat, args ) };
+    va_end( args );
+
+    pcSlot->m_uiLength = static_cast<uint32_t>( iLength < 0 ? 0 : std::min<size_t>( iLength, s_szMessageLength - 1 ) );
+
+    // Publish the message to the consumer
+    pcSlot->m_uiSequence.store( uiPosition + 1, std::memory_order_release );
+
+    return true;
+  }
+
+  struct Slot
+  {
+    // Equal to the slot's position when free, and to its position plus one once a message is published
+    std::atomic<uint64_t> m_uiSequence{ 0 };
+    uint32_t m_uiLength{ 0 };
+    char m_strMessage[s_szMessageLength];
+  };
+
+  Slot m_cSlots[s_szNumSlots];
+
+  // Producers and the consumer advance separate cursors, kept on separate cache lines
+  alignas( 64 ) std::atomic<uint64_t> m_uiEnqueuePosition{ 0 };
+  alignas( 64 ) uint64_t m_uiDequeuePosition{ 0 };
+  alignas( 64 ) std::atomic<uint64_t> m_uiNumDropped{ 0 };
+};
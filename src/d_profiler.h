@@ -0,0 +1,596 @@
+#pragma once
+
+#include <d_settings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Fixed-size blocks of per-line data for one VM, indexed by interned file id and then by line number. Blocks are
+// allocated the first time a file or range of lines is written and never move afterward, so the one thread that
+// writes can reach a line in a few array indexes, and other threads can read without a lock. Files and lines beyond
+// the table limits have no blocks.
+
+template<typename LineBlock, uint32_t LinesPerBlock>
+struct rumDebugLineBlocks
+{
+  static constexpr uint32_t s_uiFilesPerBlock{ 256 };
+  static constexpr uint32_t s_uiNumFileBlocks{ ( PROFILER_MAX_FILES + s_uiFilesPerBlock - 1 ) / s_uiFilesPerBlock };
+  static constexpr uint32_t s_uiLinesPerBlock{ LinesPerBlock };
+  static constexpr uint32_t s_uiNumLineBlocks{ ( PROFILER_MAX_LINES + s_uiLinesPerBlock - 1 ) / s_uiLinesPerBlock };
+
+  struct File
+  {
+    std::atomic<LineBlock*> m_pcLineBlocks[s_uiNumLineBlocks];
+  };
+
+  struct FileBlock
+  {
+    File m_cFiles[s_uiFilesPerBlock];
+  };
+
+  rumDebugLineBlocks() = default;
+  rumDebugLineBlocks( const rumDebugLineBlocks& ) = delete;
+  rumDebugLineBlocks& operator=( const rumDebugLineBlocks& ) = delete;
+
+  ~rumDebugLineBlocks()
+  {
+    for( auto& fileBlockIter : m_pcFileBlocks )
+    {
+      FileBlock* pcFileBlock{ fileBlockIter.load( std::memory_order_relaxed ) };
+      if( pcFileBlock )
+      {
+        for( auto& fileIter : pcFileBlock->m_cFiles )
+        {
+          for( auto& lineBlockIter : fileIter.m_pcLineBlocks )
+          {
+            delete lineBlockIter.load( std::memory_order_relaxed );
+          }
+        }
+
+        delete pcFileBlock;
+      }
+    }
+  }
+
+  // Returns the block holding the line, allocating it if needed, or null if the line is beyond the table limits. Must
+  // only be called from the one thread that writes to this table.
+  LineBlock* AcquireLineBlock( uint32_t i_uiFileID, uint32_t i_uiLine )
+  {
+    if( i_uiFileID >= PROFILER_MAX_FILES || i_uiLine >= PROFILER_MAX_LINES )
+    {
+      return nullptr;
+    }
+
+    auto& rcFileBlock{ m_pcFileBlocks[i_uiFileID / s_uiFilesPerBlock] };
+    FileBlock* pcFileBlock{ rcFileBlock.load( std::memory_order_relaxed ) };
+    if( nullptr == pcFileBlock )
+    {
+      // First line written in this range of files. Value-initialization zeroes every pointer.
+      pcFileBlock = new FileBlock();
+      rcFileBlock.store( pcFileBlock, std::memory_order_release );
+    }
+
+    File& rcFile{ pcFileBlock->m_cFiles[i_uiFileID % s_uiFilesPerBlock] };
+    auto& rcLineBlock{ rcFile.m_pcLineBlocks[i_uiLine / s_uiLinesPerBlock] };
+    LineBlock* pcLineBlock{ rcLineBlock.load( std::memory_order_relaxed ) };
+    if( nullptr == pcLineBlock )
+    {
+      // First line written in this range of lines. Value-initialization zeroes the block.
+      pcLineBlock = new LineBlock();
+      rcLineBlock.store( pcLineBlock, std::memory_order_release );
+    }
+
+    return pcLineBlock;
+  }
+
+  const File* FindFile( uint32_t i_uiFileID ) const
+  {
+    if( i_uiFileID >= PROFILER_MAX_FILES )
+    {
+      return nullptr;
+    }
+
+    const FileBlock* pcFileBlock{ m_pcFileBlocks[i_uiFileID / s_uiFilesPerBlock].load( std::memory_order_acquire ) };
+    return pcFileBlock ? &pcFileBlock->m_cFiles[i_uiFileID % s_uiFilesPerBlock] : nullptr;
+  }
+
+  // Passes each of the file's allocated blocks to the callback, along with the first line the block holds
+  template<typename Callback>
+  void ForEachLineBlock( uint32_t i_uiFileID, Callback&& i_rfnCallback ) const
+  {
+    const File* pcFile{ FindFile( i_uiFileID ) };
+    if( nullptr == pcFile )
+    {
+      return;
+    }
+
+    for( uint32_t uiBlock{ 0 }; uiBlock < s_uiNumLineBlocks; ++uiBlock )
+    {
+      LineBlock* pcLineBlock{ pcFile->m_pcLineBlocks[uiBlock].load( std::memory_order_acquire ) };
+      if( pcLineBlock )
+      {
+        i_rfnCallback( *pcLineBlock, uiBlock * s_uiLinesPerBlock );
+      }
+    }
+  }
+
+  // Passes every allocated block of every file to the callback
+  template<typename Callback>
+  void ForEachLineBlock( Callback&& i_rfnCallback ) const
+  {
+    for( const auto& fileBlockIter : m_pcFileBlocks )
+    {
+      const FileBlock* pcFileBlock{ fileBlockIter.load( std::memory_order_acquire ) };
+      if( nullptr == pcFileBlock )
+      {
+        continue;
+      }
+
+      for( const auto& fileIter : pcFileBlock->m_cFiles )
+      {
+        for( const auto& lineBlockIter : fileIter.m_pcLineBlocks )
+        {
+          LineBlock* pcLineBlock{ lineBlockIter.load( std::memory_order_acquire ) };
+          if( pcLineBlock )
+          {
+            i_rfnCallback( *pcLineBlock );
+          }
+        }
+      }
+    }
+  }
+
+  std::atomic<FileBlock*> m_pcFileBlocks[s_uiNumFileBlocks]{};
+};
+
+
+// Executed or sampled line counts for one VM. Only one thread counts lines, while the interface reads and resets the
+// counts concurrently. Counting a line is a few array indexes and an increment.
+
+struct rumDebugLineCounts
+{
+  static constexpr uint32_t s_uiLinesPerBlock{ 1024 };
+
+  struct LineBlock
+  {
+    std::atomic<uint32_t> m_uiCounts[s_uiLinesPerBlock];
+  };
+
+  // Adds the file's line counts to the vector, which is grown to fit, and returns the highest resulting count
+  uint32_t GetCounts( uint32_t i_uiFileID, std::vector<uint32_t>& io_vCounts ) const
+  {
+    uint32_t uiMaxCount{ 0 };
+
+    m_cBlocks.ForEachLineBlock( i_uiFileID, [&]( const LineBlock& i_rcLineBlock, uint32_t i_uiFirstLine )
+    {
+      for( uint32_t uiOffset{ 0 }; uiOffset < s_uiLinesPerBlock; ++uiOffset )
+      {
+        const uint32_t uiCount{ i_rcLineBlock.m_uiCounts[uiOffset].load( std::memory_order_relaxed ) };
+        if( 0 == uiCount )
+        {
+          continue;
+        }
+
+        const size_t szLine{ static_cast<size_t>( i_uiFirstLine ) + uiOffset };
+        if( szLine >= io_vCounts.size() )
+        {
+          io_vCounts.resize( szLine + 1, 0 );
+        }
+
+        io_vCounts[szLine] += uiCount;
+        uiMaxCount = std::max( uiMaxCount, io_vCounts[szLine] );
+      }
+    } );
+
+    return uiMaxCount;
+  }
+
+  // Counts a line. Must only be called from the one thread that counts lines into this table.
+  void Increment( uint32_t i_uiFileID, uint32_t i_uiLine )
+  {
+    LineBlock* pcLineBlock{ m_cBlocks.AcquireLineBlock( i_uiFileID, i_uiLine ) };
+    if( pcLineBlock )
+    {
+      // An atomic add rather than a load and store, so that a concurrent reset is never overwritten
+      pcLineBlock->m_uiCounts[i_uiLine % s_uiLinesPerBlock].fetch_add( 1, std::memory_order_relaxed );
+    }
+  }
+
+  // Zeroes every count. Blocks stay allocated so that counting never has to allocate again.
+  void Reset()
+  {
+    m_cBlocks.ForEachLineBlock( []( LineBlock& io_rcLineBlock )
+    {
+      for( auto& iter : io_rcLineBlock.m_uiCounts )
+      {
+        iter.store( 0, std::memory_order_relaxed );
+      }
+    } );
+  }
+
+  rumDebugLineBlocks<LineBlock, s_uiLinesPerBlock> m_cBlocks;
+};
+
+
+// Covered lines for one VM, one bit per line. Only the VM's thread marks lines, while the interface reads and resets
+// them concurrently. Once a line is marked, marking it again is a few array indexes and a single bit test.
+
+struct rumDebugLineCoverage
+{
+  static constexpr uint32_t s_uiLinesPerBlock{ 4096 };
+  static constexpr uint32_t s_uiWordsPerBlock{ s_uiLinesPerBlock / 64 };
+
+  struct LineBlock
+  {
+    std::atomic<uint64_t> m_uiWords[s_uiWordsPerBlock];
+  };
+
+  // ORs the file's covered lines into the bitset, which is grown to fit and indexed by line. Returns false if no lines
+  // of the file are covered.
+  bool GetLines( uint32_t i_uiFileID, std::vector<uint64_t>& io_vWords ) const
+  {
+    bool bCovered{ false };
+
+    m_cBlocks.ForEachLineBlock( i_uiFileID, [&]( const LineBlock& i_rcLineBlock, uint32_t i_uiFirstLine )
+    {
+      const size_t szFirstWord{ i_uiFirstLine / 64 };
+      for( uint32_t uiWord{ 0 }; uiWord < s_uiWordsPerBlock; ++uiWord )
+      {
+        const uint64_t uiBits{ i_rcLineBlock.m_uiWords[uiWord].load( std::memory_order_relaxed ) };
+        if( 0 == uiBits )
+        {
+          continue;
+        }
+
+        if( szFirstWord + uiWord >= io_vWords.size() )
+        {
+          io_vWords.resize( szFirstWord + uiWord + 1, 0 );
+        }
+
+        io_vWords[szFirstWord + uiWord] |= uiBits;
+        bCovered = true;
+      }
+    } );
+
+    return bCovered;
+  }
+
+  static bool IsLineCovered( const std::vector<uint64_t>& i_vWords, uint32_t i_uiLine )
+  {
+    const size_t szWord{ i_uiLine >> 6 };
+    return szWord < i_vWords.size() && ( ( i_vWords[szWord] >> ( i_uiLine & 63 ) ) & 1 );
+  }
+
+  // Marks a line as covered. Must only be called from the VM's thread.
+  void Mark( uint32_t i_uiFileID, uint32_t i_uiLine )
+  {
+    LineBlock* pcLineBlock{ m_cBlocks.AcquireLineBlock( i_uiFileID, i_uiLine ) };
+    if( nullptr == pcLineBlock )
+    {
+      return;
+    }
+
+    auto& rcWord{ pcLineBlock->m_uiWords[( i_uiLine % s_uiLinesPerBlock ) >> 6] };
+    const uint64_t uiBit{ uint64_t{ 1 } << ( i_uiLine & 63 ) };
+    if( 0 == ( rcWord.load( std::memory_order_relaxed ) & uiBit ) )
+    {
+      // An atomic or rather than a load and store, so that a concurrent reset is never overwritten
+      rcWord.fetch_or( uiBit, std::memory_order_relaxed );
+    }
+  }
+
+  // Clears every line. Blocks stay allocated so that marking never has to allocate again.
+  void Reset()
+  {
+    m_cBlocks.ForEachLineBlock( []( LineBlock& io_rcLineBlock )
+    {
+      for( auto& iter : io_rcLineBlock.m_uiWords )
+      {
+        iter.store( 0, std::memory_order_relaxed );
+      }
+    } );
+  }
+
+  rumDebugLineBlocks<LineBlock, s_uiLinesPerBlock> m_cBlocks;
+};
+
+
+// Where profiler views get their data from: exact counts and timings from the debug hook, or statistical samples
+
+enum class rumDebugProfileSource
+{
+  Instrumented,
+  Sampled
+};
+
+
+// A script function seen by the function profiler, identified by its source, name, and first executed line
+
+struct rumDebugProfileFunction
+{
+  std::string m_strSource;
+
+  // The function name, which is empty for anonymous functions
+  std::string m_strFunction;
+
+  int32_t m_iLine{ 0 };
+};
+
+
+// Aggregated call timings for one VM, either measured or estimated from samples. Each node is a function reached
+// through a distinct call path, so a function appears once under each of its callers. Node 0 is the root, which
+// stands for the native code that called into script. Nodes are only ever appended, so node indexes stay valid until
+// the tree is cleared.
+
+struct rumDebugCallTree
+{
+  static constexpr uint32_t s_uiInvalidIndex{ UINT32_MAX };
+
+  struct Node
+  {
+    // The index into m_vFunctions, or s_uiInvalidIndex for the root
+    uint32_t m_uiFunction{ s_uiInvalidIndex };
+
+    uint32_t m_uiParent{ s_uiInvalidIndex };
+    uint32_t m_uiFirstChild{ s_uiInvalidIndex };
+    uint32_t m_uiNextSibling{ s_uiInvalidIndex };
+
+    // The number of calls through this node, or for sampled trees, the number of samples taken in the node itself
+    uint64_t m_uiNumCalls{ 0 };
+
+    // Time spent in calls through this node, with and without the time spent in its children
+    int64_t m_iInclusiveNS{ 0 };
+    int64_t m_iExclusiveNS{ 0 };
+  };
+
+  rumDebugCallTree()
+  {
+    m_vNodes.emplace_back();
+  }
+
+  uint32_t AddChild( uint32_t i_uiParent, uint32_t i_uiFunction )
+  {
+    const auto uiNode{ static_cast<uint32_t>( m_vNodes.size() ) };
+
+    Node& rcNode{ m_vNodes.emplace_back() };
+    rcNode.m_uiFunction = i_uiFunction;
+    rcNode.m_uiParent = i_uiParent;
+    rcNode.m_uiNextSibling = m_vNodes[i_uiParent].m_uiFirstChild;
+
+    m_vNodes[i_uiParent].m_uiFirstChild = uiNode;
+
+    return uiNode;
+  }
+
+  // Removes every node but the root. Functions are kept, since their ids are cached by the profiler.
+  void ClearNodes()
+  {
+    m_vNodes.resize( 1 );
+    m_vNodes[0] = Node();
+  }
+
+  std::vector<rumDebugProfileFunction> m_vFunctions;
+  std::vector<Node> m_vNodes;
+};
+
+
+// Every function seen by the profilers of one VM, indexed by function id. Only the VM's thread adds functions, while
+// any thread can read the functions added so far. Entries are stored in fixed-size blocks that never move, so readers
+// need no lock. Once the table is full, further functions share a final catch-all entry.
+
+struct rumDebugProfileFunctions
+{
+  static constexpr uint32_t s_uiFunctionsPerBlock{ 256 };
+  static constexpr uint32_t s_uiNumBlocks{ ( PROFILER_MAX_FUNCTIONS + s_uiFunctionsPerBlock - 1 ) /
+                                           s_uiFunctionsPerBlock };
+  static constexpr uint32_t s_uiMaxFunctions{ s_uiNumBlocks * s_uiFunctionsPerBlock };
+
+  struct Block
+  {
+    rumDebugProfileFunction m_cFunctions[s_uiFunctionsPerBlock];
+  };
+
+  rumDebugProfileFunctions() = default;
+  rumDebugProfileFunctions( const rumDebugProfileFunctions& ) = delete;
+  rumDebugProfileFunctions& operator=( const rumDebugProfileFunctions& ) = delete;
+
+  ~rumDebugProfileFunctions()
+  {
+    for( auto& iter : m_pcBlocks )
+    {
+      delete iter.load( std::memory_order_relaxed );
+    }
+  }
+
+  // Adds a function and returns its id. Must only be called from the VM's thread.
+  uint32_t Add( rumDebugProfileFunction&& i_rcFunction )
+  {
+    uint32_t uiFunction{ m_uiNumFunctions.load( std::memory_order_relaxed ) };
+    if( uiFunction == s_uiMaxFunctions )
+    {
+      // Full, so the function shares the catch-all entry
+      return s_uiMaxFunctions - 1;
+    }
+
+    if( uiFunction == s_uiMaxFunctions - 1 )
+    {
+      i_rcFunction = { "", "(untracked functions)", 0 };
+    }
+
+    auto& rcBlock{ m_pcBlocks[uiFunction / s_uiFunctionsPerBlock] };
+    Block* pcBlock{ rcBlock.load( std::memory_order_relaxed ) };
+    if( nullptr == pcBlock )
+    {
+      pcBlock = new Block();
+      rcBlock.store( pcBlock, std::memory_order_release );
+    }
+
+    pcBlock->m_cFunctions[uiFunction % s_uiFunctionsPerBlock] = std::move( i_rcFunction );
+
+    // Publish the function to readers
+    m_uiNumFunctions.store( uiFunction + 1, std::memory_order_release );
+
+    return uiFunction;
+  }
+
+  // Appends the functions the vector doesn't have yet, so that it can be indexed by function id
+  void CopyTo( std::vector<rumDebugProfileFunction>& io_vFunctions ) const
+  {
+    const uint32_t uiNumFunctions{ m_uiNumFunctions.load( std::memory_order_acquire ) };
+    for( auto uiFunction{ static_cast<uint32_t>( io_vFunctions.size() ) }; uiFunction < uiNumFunctions; ++uiFunction )
+    {
+      const Block* pcBlock{ m_pcBlocks[uiFunction / s_uiFunctionsPerBlock].load( std::memory_order_acquire ) };
+      io_vFunctions.push_back( pcBlock->m_cFunctions[uiFunction % s_uiFunctionsPerBlock] );
+    }
+  }
+
+  std::atomic<Block*> m_pcBlocks[s_uiNumBlocks]{};
+  std::atomic<uint32_t> m_uiNumFunctions{ 0 };
+};
+
+
+// A call stack captured by the sampler on the VM's thread
+
+struct rumDebugSample
+{
+  // The line that was executing
+  uint32_t m_uiFileID{ 0 };
+  uint32_t m_uiLine{ 0 };
+
+  // Function ids of the executing script functions, innermost first. Only the innermost SAMPLER_MAX_FRAMES frames of
+  // deeper stacks are kept.
+  uint32_t m_uiNumFrames{ 0 };
+  uint32_t m_uiFunctions[SAMPLER_MAX_FRAMES];
+};
+
+
+// A fixed-size queue of items from one VM's thread to one consumer thread. Pushing never blocks or allocates - when
+// the consumer falls behind, new items are dropped and counted instead.
+
+template<typename Item, size_t NumItems>
+struct rumDebugEventBuffer
+{
+  static constexpr size_t s_szNumItems{ NumItems };
+
+  static_assert( ( s_szNumItems & ( s_szNumItems - 1 ) ) == 0, "Event buffer sizes must be a power of two" );
+
+  // Returns the item to fill before calling EndPush, or null if the buffer is full. Only the VM's thread may push.
+  Item* BeginPush()
+  {
+    const uint64_t uiHead{ m_uiHead.load( std::memory_order_relaxed ) };
+    if( uiHead - m_uiTail.load( std::memory_order_acquire ) >= s_szNumItems )
+    {
+      m_uiNumDropped.fetch_add( 1, std::memory_order_relaxed );
+      return nullptr;
+    }
+
+    return &m_cItems[uiHead & ( s_szNumItems - 1 )];
+  }
+
+  // Consumes all pushed items, oldest first. Only one thread may drain the buffer at a time.
+  template<typename Callback>
+  size_t Drain( Callback&& i_rfnCallback )
+  {
+    uint64_t uiTail{ m_uiTail.load( std::memory_order_relaxed ) };
+    const uint64_t uiHead{ m_uiHead.load( std::memory_order_acquire ) };
+    const auto szNumDrained{ static_cast<size_t>( uiHead - uiTail ) };
+
+    for( ; uiTail != uiHead; ++uiTail )
+    {
+      i_rfnCallback( m_cItems[uiTail & ( s_szNumItems - 1 )] );
+    }
+
+    // Hand the slots back to the VM's thread
+    m_uiTail.store( uiTail, std::memory_order_release );
+
+    return szNumDrained;
+  }
+
+  // Publishes the item returned by BeginPush
+  void EndPush()
+  {
+    m_uiHead.store( m_uiHead.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+  }
+
+  uint64_t GetNumDropped() const
+  {
+    return m_uiNumDropped.load( std::memory_order_relaxed );
+  }
+
+  // Copies the item into the buffer. Returns false if the buffer was full.
+  bool Push( const Item& i_rcItem )
+  {
+    Item* pcItem{ BeginPush() };
+    if( nullptr == pcItem )
+    {
+      return false;
+    }
+
+    *pcItem = i_rcItem;
+    EndPush();
+
+    return true;
+  }
+
+  Item m_cItems[s_szNumItems];
+
+  // The VM's thread and the consumer advance separate cursors, kept on separate cache lines
+  alignas( 64 ) std::atomic<uint64_t> m_uiHead{ 0 };
+  alignas( 64 ) std::atomic<uint64_t> m_uiTail{ 0 };
+  alignas( 64 ) std::atomic<uint64_t> m_uiNumDropped{ 0 };
+};
+
+
+// Samples from one VM's thread awaiting the sampler thread
+
+using rumDebugSampleBuffer = rumDebugEventBuffer<rumDebugSample, SAMPLER_BUFFER_SAMPLES>;
+
+
+// A timestamped profiling event recorded on a VM's thread for trace export
+
+struct rumDebugTraceEvent
+{
+  enum class Type : uint8_t
+  {
+    // A script function was entered
+    Call,
+
+    // The innermost call returned
+    Return,
+
+    // The sampler sampled the line
+    Sample,
+
+    // The VM was suspended in the debugger for the duration
+    Pause
+  };
+
+  static int64_t ToTimeNS( std::chrono::steady_clock::time_point i_tTime )
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( i_tTime.time_since_epoch() ).count();
+  }
+
+  // Steady clock time since its epoch
+  int64_t m_iTimeNS{ 0 };
+  int64_t m_iDurationNS{ 0 };
+
+  // The called or sampled function id, and the sampled line
+  uint32_t m_uiFunction{ 0 };
+  uint32_t m_uiLine{ 0 };
+
+  // The call depth of a call or return. A call and its return share the same depth, which lets the writer pair them
+  // up even when the buffer was full for one of the two.
+  int32_t m_iCallDepth{ 0 };
+
+  Type m_eType{ Type::Call };
+};
+
+
+// Trace events from one VM's thread awaiting the export writer thread
+
+using rumDebugTraceBuffer = rumDebugEventBuffer<rumDebugTraceEvent, TRACE_BUFFER_EVENTS>;
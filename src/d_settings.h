@@ -8,9 +8,74 @@
 // The number of lines of data to preview before offering an expandable section that opens in a modal window
 #define NUM_VARIABLE_PREVIEW_LINES 3
 
+// The number of children fetched from a paused VM at a time as an expanded variable is scrolled through
+#define VARIABLE_PAGE_SIZE 128
+
+// Set to non-zero to sort the entries of table descriptions by key rather than listing them in iteration order
+#define SORT_VARIABLE_DESCRIPTIONS 0
+
+// Limits on describing nested containers. Containers nested deeper than FORMAT_MAX_DEPTH, or reached after the VM has
+// spent FORMAT_TIME_BUDGET_MS milliseconds formatting since it last woke, are summarized and marked as truncated.
+#define FORMAT_MAX_DEPTH 8
+#define FORMAT_TIME_BUDGET_MS 50
+
+// The number of members of a table, array, or instance hashed into its value fingerprint, which is how changes made to
+// a container in place are noticed between pauses. Members past the limit, and changes made within nested containers,
+// are not noticed.
+#define FINGERPRINT_MAX_MEMBERS 64
+
 // The buffer size to use for filename handling
 #define MAX_FILENAME_LENGTH 260
 
+// The buffer size to use for editing script expressions, such as breakpoint conditions
+#define MAX_EXPRESSION_LENGTH 512
+
+// The longest a breakpoint condition or logpoint message may run, in milliseconds, before it is disabled. These run
+// on the VM's thread and Squirrel can't interrupt them, so this is checked after each evaluation. An expression that
+// never finishes will block the VM's thread.
+#define CONDITION_TIME_BUDGET_MS 5
+
+// The longest a watch expression may run, in milliseconds, before it is disabled. It is checked the same way as
+// CONDITION_TIME_BUDGET_MS, so it has the same limit.
+#define WATCH_TIME_BUDGET_MS 20
+
+// The number of logpoint messages that can await display before new messages are dropped. Must be a power of two.
+#define LOGPOINT_BUFFER_SLOTS 4096
+
+// The longest logpoint message kept, including its VM, file, and line prefix. Longer messages are truncated.
+#define LOGPOINT_MESSAGE_LENGTH 256
+
+// The line profiler counts lines in files with interned ids below PROFILER_MAX_FILES, up to line PROFILER_MAX_LINES
+#define PROFILER_MAX_FILES 4096
+#define PROFILER_MAX_LINES 65536
+
+// How often, in milliseconds, a VM's function profiler timings are copied for display
+#define PROFILER_PUBLISH_INTERVAL_MS 250
+
+// The most functions the profilers track per VM. Functions beyond this are reported as a single untracked entry.
+#define PROFILER_MAX_FUNCTIONS 65536
+
+// The sampler's default rate and the range it can be set to, in samples per second
+#define SAMPLER_DEFAULT_RATE_HZ 1000
+#define SAMPLER_MIN_RATE_HZ 10
+#define SAMPLER_MAX_RATE_HZ 10000
+
+// The number of samples each VM can hold awaiting aggregation before new samples are dropped. Must be a power of two.
+#define SAMPLER_BUFFER_SAMPLES 1024
+
+// The deepest call stack a sample captures. The outermost frames of deeper stacks are left out.
+#define SAMPLER_MAX_FRAMES 64
+
+// The number of trace events each VM can hold awaiting the export writer before new events are dropped. Must be a
+// power of two.
+#define TRACE_BUFFER_EVENTS 65536
+
+// Exports are written to disk in chunks of about this many bytes
+#define EXPORT_CHUNK_BYTES 65536
+
+// How often, in milliseconds, the export writer collects trace events
+#define EXPORT_WRITE_INTERVAL_MS 50
+
 // Set to non-zero to enable some helpful debug logging
 #define DEBUG_OUTPUT 0
 
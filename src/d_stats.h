@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Counters of the debugger's own overhead in one VM. Only the VM's thread updates them, so a relaxed load and store
+// is enough and the hook never pays for an atomic add. Any thread can read them.
+
+struct rumDebugHookStats
+{
+  static void Add( std::atomic<uint64_t>& io_rcCounter, uint64_t i_uiAmount )
+  {
+    io_rcCounter.store( io_rcCounter.load( std::memory_order_relaxed ) + i_uiAmount, std::memory_order_relaxed );
+  }
+
+  // Debug hook invocations by event type
+  std::atomic<uint64_t> m_uiNumCallEvents{ 0 };
+  std::atomic<uint64_t> m_uiNumReturnEvents{ 0 };
+  std::atomic<uint64_t> m_uiNumLineEvents{ 0 };
+
+  // Time spent in the debug hook, less time spent paused. Only measured while hook timing is enabled.
+  std::atomic<uint64_t> m_uiHookNS{ 0 };
+
+  // Lines and calls tested against the breakpoint index
+  std::atomic<uint64_t> m_uiNumBreakpointChecks{ 0 };
+
+  // Times the VM was suspended in the debugger, and for how long
+  std::atomic<uint64_t> m_uiNumPauses{ 0 };
+  std::atomic<uint64_t> m_uiPausedNS{ 0 };
+};
+
+
+// Adds the time the debug hook runs for to the VM's stats, leaving out any time spent paused in the debugger
+
+struct rumDebugHookTimer
+{
+  rumDebugHookTimer( rumDebugHookStats& io_rcStats, bool i_bEnabled )
+    : m_pcStats( i_bEnabled ? &io_rcStats : nullptr )
+  {
+    if( m_pcStats )
+    {
+      m_uiPausedNS = m_pcStats->m_uiPausedNS.load( std::memory_order_relaxed );
+      m_tStart = std::chrono::steady_clock::now();
+    }
+  }
+
+  rumDebugHookTimer( const rumDebugHookTimer& ) = delete;
+  rumDebugHookTimer& operator=( const rumDebugHookTimer& ) = delete;
+
+  ~rumDebugHookTimer()
+  {
+    if( m_pcStats )
+    {
+      const auto iElapsedNS{ std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_tStart ).count() };
+      const uint64_t uiPausedNS{ m_pcStats->m_uiPausedNS.load( std::memory_order_relaxed ) - m_uiPausedNS };
+      const auto uiElapsedNS{ static_cast<uint64_t>( iElapsedNS ) };
+
+      rumDebugHookStats::Add( m_pcStats->m_uiHookNS, uiElapsedNS > uiPausedNS ? uiElapsedNS - uiPausedNS : 0 );
+    }
+  }
+
+  rumDebugHookStats* m_pcStats{ nullptr };
+  std::chrono::steady_clock::time_point m_tStart;
+  uint64_t m_uiPausedNS{ 0 };
+};
+
+
+// Adds the time between construction and destruction to a counter that any thread may add to
+
+struct rumDebugScopeTimer
+{
+  explicit rumDebugScopeTimer( std::atomic<uint64_t>& io_rcCounterNS )
+    : m_rcCounterNS( io_rcCounterNS )
+    , m_tStart( std::chrono::steady_clock::now() )
+  {}
+
+  rumDebugScopeTimer( const rumDebugScopeTimer& ) = delete;
+  rumDebugScopeTimer& operator=( const rumDebugScopeTimer& ) = delete;
+
+  ~rumDebugScopeTimer()
+  {
+    const auto iElapsedNS{ std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - m_tStart ).count() };
+    m_rcCounterNS.fetch_add( static_cast<uint64_t>( iElapsedNS ), std::memory_order_relaxed );
+  }
+
+  std::atomic<uint64_t>& m_rcCounterNS;
+  std::chrono::steady_clock::time_point m_tStart;
+};
+
+
+// A snapshot of the debugger's own overhead, summed over every VM since the stats were last reset
+
+struct rumDebugStats
+{
+  uint64_t m_uiNumCallEvents{ 0 };
+  uint64_t m_uiNumReturnEvents{ 0 };
+  uint64_t m_uiNumLineEvents{ 0 };
+
+  // Only measured while hook timing is enabled
+  uint64_t m_uiHookNS{ 0 };
+
+  uint64_t m_uiNumBreakpointChecks{ 0 };
+
+  uint64_t m_uiNumPauses{ 0 };
+  uint64_t m_uiPausedNS{ 0 };
+
+  // Variables formatted for the Locals and Watched tabs, and the time spent formatting them
+  uint64_t m_uiNumFormattedVariables{ 0 };
+  uint64_t m_uiFormatNS{ 0 };
+
+  // Variables that kept their formatting from the last build because their values hadn't changed
+  uint64_t m_uiNumReusedVariables{ 0 };
+
+  // The files currently cached for display and the memory their text and line offsets use. These aren't reset.
+  uint64_t m_uiNumCachedFiles{ 0 };
+  uint64_t m_uiCachedFileBytes{ 0 };
+};
+
+
+// Frame timings of the debugger interface's panels, in the order they are listed by the Stats window
+
+enum class rumDebugPanel : uint32_t
+{
+  Frame,
+  FileExplorer,
+  SourceCode,
+  Watched,
+  Locals,
+  Callstack,
+  Breakpoints,
+  Console,
+  Profiler,
+  VMs,
+  NumPanels
+};
+
+
+// Frame timings of one interface panel. Only the interface thread writes them, while any thread can read them.
+
+struct rumDebugPanelCounters
+{
+  std::atomic<uint64_t> m_uiLastNS{ 0 };
+  std::atomic<uint64_t> m_uiTotalNS{ 0 };
+  std::atomic<uint64_t> m_uiNumFrames{ 0 };
+};
+
+
+// Times one frame of an interface panel
+
+struct rumDebugPanelTimer
+{
+  explicit rumDebugPanelTimer( rumDebugPanelCounters& io_rcCounters )
+    : m_rcCounters( io_rcCounters )
+    , m_tStart( std::chrono::steady_clock::now() )
+  {}
+
+  rumDebugPanelTimer( const rumDebugPanelTimer& ) = delete;
+  rumDebugPanelTimer& operator=( const rumDebugPanelTimer& ) = delete;
+
+  ~rumDebugPanelTimer()
+  {
+    const auto uiElapsedNS{ static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - m_tStart ).count() ) };
+
+    m_rcCounters.m_uiLastNS.store( uiElapsedNS, std::memory_order_relaxed );
+    m_rcCounters.m_uiTotalNS.store( m_rcCounters.m_uiTotalNS.load( std::memory_order_relaxed ) + uiElapsedNS,
+                                    std::memory_order_relaxed );
+    m_rcCounters.m_uiNumFrames.store( m_rcCounters.m_uiNumFrames.load( std::memory_order_relaxed ) + 1,
+                                      std::memory_order_relaxed );
+  }
+
+  rumDebugPanelCounters& m_rcCounters;
+  std::chrono::steady_clock::time_point m_tStart;
+};
+
+
+// A snapshot of one interface panel's frame timings
+
+struct rumDebugPanelTiming
+{
+  const char* m_strName{ "" };
+
+  // The time the panel took to build in the most recent frame it was shown, and on average over the frames it was
+  // shown since the timings were last reset
+  uint64_t m_uiLastNS{ 0 };
+  uint64_t m_uiAverageNS{ 0 };
+};
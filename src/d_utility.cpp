@@ -31,288 +31,334 @@ SOFTWARE.
 #include <d_settings.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 
 namespace rumDebugUtility
 {
-  std::string BuildInstanceDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex )
-  {
-#if DEBUG_OUTPUT
-    SQInteger iTopBegin{ sq_gettop( i_pcVM ) };
-#endif
+  // Bumped each time a VM pauses, invalidating the object name index
+  std::atomic<uint32_t> g_uiObjectNameEpoch{ 0 };
 
-    HSQOBJECT sqInstance;
-    sq_getstackobj( i_pcVM, -1, &sqInstance );
-    if( !sq_isinstance( sqInstance ) )
-    {
-#if DEBUG_OUTPUT
-      SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
-      assert( iTopBegin == iTopEnd );
-#endif
+  // The names of the containers in the root and const tables keyed by hash, and the VM and epoch they were indexed
+  // for. Each thread that formats variables keeps its own index.
+  thread_local std::unordered_map<SQHash, std::string> g_mapObjectNames;
+  thread_local HSQUIRRELVM g_pcObjectNameVM{ nullptr };
+  thread_local uint32_t g_uiObjectNameIndexEpoch{ 0 };
+  thread_local bool g_bObjectNamesIndexed{ false };
 
-      return "";
-    }
+  // The containers being described, outermost first, for catching cycles and limiting depth
+  thread_local std::vector<const void*> g_vFormatPath;
 
-    std::string strDesc;
+  // Containers reached after this time are summarized rather than described
+  thread_local std::chrono::steady_clock::time_point g_tFormatDeadline{ std::chrono::steady_clock::time_point::max() };
 
-    // Get the class of the instance so that we can iterate over its member keys
-    sq_getclass( i_pcVM, -1 );
 
-    HSQOBJECT sqClass;
-    sq_getstackobj( i_pcVM, -1, &sqClass );
+  ///////////////
+  // Prototypes
+  ///////////////
 
-    std::string strName{ GetObjectName( i_pcVM, sqClass ) };
-    if( !strName.empty() )
-    {
-      strDesc = '<' + strName + ">\n";
-    }
+  // Describes the table, array, class, or instance at the stack index, unless doing so would recurse into a cycle, go
+  // too deep, or run past the time budget. It is then summarized and marked as truncated instead.
+  void AppendContainerDescription( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex,
+                                   std::string& io_strOutput );
 
-    bool bSuccess{ true };
-    SQInteger iIndex{ 0 };
-    do
-    {
-      // Push iteration index
-      sq_pushinteger( i_pcVM, iIndex );
+  // Append descriptions of the table, array, class, or instance at the top of the stack to the output
+  void AppendInstanceDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex, std::string& io_strOutput );
+  void AppendTableDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex, std::string& io_strOutput );
 
-      // Get the next member
-      bSuccess = SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) );
-      if( bSuccess )
-      {
-        if( 0 != iIndex )
-        {
-          strDesc += "\n";
-        }
+  void BuildObjectNameIndex( HSQUIRRELVM i_pcVM );
 
-        // Get the member value
-        HSQOBJECT sqValue;
-        sq_getstackobj( i_pcVM, -1, &sqValue );
+  // Hashes the first FINGERPRINT_MAX_MEMBERS keys and values of the table, array, or instance at the stack index into
+  // the hash. Numbers and bools are hashed by value and everything else by identity, which covers strings since
+  // Squirrel interns them.
+  uint64_t HashMembers( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, uint64_t i_uiHash );
 
-        // Get the member key
-        HSQOBJECT sqKey;
-        sq_getstackobj( i_pcVM, -2, &sqKey );
+  // Pushes the root of the access path, found as a local of the frame, in the root or const table, or as a member of
+  // this. Returns false if it wasn't found.
+  bool PushAccessPathRoot( HSQUIRRELVM i_pcVM, rumDebugAccessPath& io_rcPath, uint32_t i_uiStackLevel );
 
-        // Get the next iteration index
-        sq_getinteger( i_pcVM, -3, &iIndex );
 
-        sq_pop( i_pcVM, 3 );
+  void AdvanceObjectNameEpoch()
+  {
+    g_uiObjectNameEpoch.fetch_add( 1, std::memory_order_relaxed );
+  }
 
-        // Put the instance and the desired key on the stack
-        sq_pushobject( i_pcVM, sqInstance );
-        sq_pushstring( i_pcVM, sq_objtostring( &sqKey ), -1 );
 
-        strDesc += FormatVariable( i_pcVM, -1, i_bValuesAsHex );
+  void AppendContainerDescription( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex,
+                                   std::string& io_strOutput )
+  {
+    HSQOBJECT sqObject;
+    sq_getstackobj( i_pcVM, i_iIndex, &sqObject );
+
+    const void* pcIdentity{ sqObject._unVal.pRefCounted };
 
-        // Get the object from the table
-        HSQOBJECT slotObj;
-        sq_get( i_pcVM, -2 );
-        sq_getstackobj( i_pcVM, -1, &slotObj );
+    const char* strTruncation{ nullptr };
+    if( std::find( g_vFormatPath.begin(), g_vFormatPath.end(), pcIdentity ) != g_vFormatPath.end() )
+    {
+      strTruncation = "cycle";
+    }
+    else if( g_vFormatPath.size() >= FORMAT_MAX_DEPTH )
+    {
+      strTruncation = "depth limit";
+    }
+    else if( std::chrono::steady_clock::now() > g_tFormatDeadline )
+    {
+      strTruncation = "time budget";
+    }
 
-        std::string strValue{ FormatVariable( i_pcVM, -1, i_bValuesAsHex ) };
+    if( strTruncation )
+    {
+      // The summary still identifies the container, which can be expanded in the variable tree
+      AppendVariableSummary( i_pcVM, i_iIndex, i_bValuesAsHex, io_strOutput );
+      io_strOutput += " <truncated: ";
+      io_strOutput += strTruncation;
+      io_strOutput += '>';
+      return;
+    }
 
-        // Pop the fetched object
-        sq_poptop( i_pcVM );
+    g_vFormatPath.push_back( pcIdentity );
 
-        // Copy the key name
-        strDesc += ": " + strValue;
-      }
+    // Descriptions only look at the top of the stack
+    sq_push( i_pcVM, i_iIndex );
 
-      // Pop the iterator index
-      sq_poptop( i_pcVM );
-    } while( bSuccess );
+    if( sq_type( sqObject ) == OT_INSTANCE )
+    {
+      AppendInstanceDescription( i_pcVM, i_bValuesAsHex, io_strOutput );
+    }
+    else
+    {
+      AppendTableDescription( i_pcVM, i_bValuesAsHex, io_strOutput );
+    }
 
-    // Pop the fetched class
     sq_poptop( i_pcVM );
 
-#if DEBUG_OUTPUT
-    SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
-    assert( iTopBegin == iTopEnd );
-#endif
-
-    return strDesc;
+    g_vFormatPath.pop_back();
   }
 
 
-  std::string BuildTableDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex )
+  void AppendFloat( SQFloat i_fValue, std::string& io_strOutput )
   {
-    std::string strDesc;
+    char strBuffer[64];
+    char* pcEnd{ std::to_chars( std::begin( strBuffer ), std::end( strBuffer ), i_fValue ).ptr };
+    io_strOutput.append( strBuffer, pcEnd );
+
+    // Keep whole numbers recognizable as floats
+    if( std::isfinite( i_fValue ) &&
+        std::none_of( strBuffer, pcEnd, []( char i_cChar ) { return '.' == i_cChar || 'e' == i_cChar; } ) )
+    {
+      io_strOutput += ".0";
+    }
+  }
+
 
+  void AppendInstanceDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex, std::string& io_strOutput )
+  {
 #if DEBUG_OUTPUT
     SQInteger iTopBegin{ sq_gettop( i_pcVM ) };
 #endif
 
-    HSQOBJECT sqObject;
-    sq_getstackobj( i_pcVM, -1, &sqObject );
-    std::string strName{ GetObjectName( i_pcVM, sqObject ) };
-    if( !strName.empty() )
+    HSQOBJECT sqInstance;
+    sq_getstackobj( i_pcVM, -1, &sqInstance );
+
+    // Get the class of the instance so that we can iterate over its member keys
+    if( !sq_isinstance( sqInstance ) || SQ_FAILED( sq_getclass( i_pcVM, -1 ) ) )
     {
-      strDesc = '<' + strName + ">\n";
+      return;
     }
 
-    // For now, skip over large tables
-    const auto iSize{ sq_getsize( i_pcVM, -1 ) };
-    if( iSize < 100 )
+    HSQOBJECT sqClass;
+    sq_getstackobj( i_pcVM, -1, &sqClass );
+
+    const std::string strName{ GetObjectName( i_pcVM, sqClass ) };
+    if( !strName.empty() )
     {
-      using TableEntry = std::pair<std::string, SQInteger>;
-      std::vector<TableEntry> vTableEntries;
+      io_strOutput += '<';
+      io_strOutput += strName;
+      io_strOutput += ">\n";
+    }
 
-      SQInteger iIndex{ 0 };
-      sq_pushinteger( i_pcVM, iIndex );
+    bool bFirst{ true };
 
-      for( SQInteger i = 0;
-           SQ_SUCCEEDED( sq_getinteger( i_pcVM, -1, &iIndex ) ) && SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) );
-           ++i )
+    sq_pushnull( i_pcVM );
+    const SQInteger iIterTop{ sq_gettop( i_pcVM ) };
+
+    while( SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) ) )
+    {
+      if( !bFirst )
       {
-        sq_poptop( i_pcVM );
-        vTableEntries.emplace_back( TableEntry{ FormatVariable( i_pcVM, -1, i_bValuesAsHex ), iIndex } );
-        sq_poptop( i_pcVM );
+        io_strOutput += '\n';
       }
 
-      sq_poptop( i_pcVM );
+      bFirst = false;
 
-      /*std::sort(vTableEntries.begin(), vTableEntries.end(),
-                 []( const TableEntry& lhs, const TableEntry& rhs ) -> bool
-                 {
-                   return lhs.first < rhs.first;
-                 } );*/
+      AppendVariable( i_pcVM, -2, i_bValuesAsHex, io_strOutput );
+      io_strOutput += ": ";
 
-      int32_t iCount{ 0 };
-      for( const auto& iter : vTableEntries )
+      // Replace the class's default value with the instance's value
+      sq_poptop( i_pcVM );
+      sq_pushobject( i_pcVM, sqInstance );
+      sq_push( i_pcVM, -2 );
+      if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
       {
-        sq_pushinteger( i_pcVM, iter.second );
-        if( !SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) ) )
-        {
-          sq_poptop( i_pcVM );
-          break;
-        }
+        AppendVariable( i_pcVM, -1, i_bValuesAsHex, io_strOutput );
+      }
 
-        const auto strValue{ FormatVariable( i_pcVM, -1, i_bValuesAsHex ) };
-        if( strValue.empty() )
-        {
-          sq_pop( i_pcVM, 2 );
-        }
-        else
-        {
-          if( 0 != iCount )
-          {
-            strDesc += "\n";
-          }
+      // Pop everything but the iterator
+      sq_settop( i_pcVM, iIterTop );
+    }
 
-          sq_poptop( i_pcVM );
-          strDesc += FormatVariable( i_pcVM, -1, i_bValuesAsHex ) + ": " + strValue;
-          sq_poptop( i_pcVM );
-        }
+    // Pop the iterator and the class
+    sq_pop( i_pcVM, 2 );
 
-        sq_poptop( i_pcVM );
+#if DEBUG_OUTPUT
+    SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
+    assert( iTopBegin == iTopEnd );
+#endif
+  }
 
-        ++iCount;
-      }
+
+  void AppendInteger( SQInteger i_iValue, bool i_bAsHex, std::string& io_strOutput )
+  {
+    char strBuffer[32];
+    char* pcEnd{ nullptr };
+
+    if( i_bAsHex )
+    {
+      io_strOutput += "0x";
+      pcEnd = std::to_chars( std::begin( strBuffer ), std::end( strBuffer ),
+                             static_cast<std::make_unsigned_t<SQInteger>>( i_iValue ), 16 ).ptr;
     }
     else
     {
-      strDesc += "<table too large>";
+      pcEnd = std::to_chars( std::begin( strBuffer ), std::end( strBuffer ), i_iValue ).ptr;
     }
 
-#if DEBUG_OUTPUT
-    SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
-    assert( iTopBegin == iTopEnd );
-#endif
-
-    return strDesc;
+    io_strOutput.append( strBuffer, pcEnd );
   }
 
 
-  SQObject FindSymbol( HSQUIRRELVM i_pcVM, const std::string& i_strVariable, uint32_t i_iLocalStackLevel )
+  void AppendTableDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex, std::string& io_strOutput )
   {
-    SQObject sqObject{};
+#if DEBUG_OUTPUT
+    SQInteger iTopBegin{ sq_gettop( i_pcVM ) };
+#endif
 
-    SQInteger iTop{ sq_gettop( i_pcVM ) };
+    HSQOBJECT sqObject;
+    sq_getstackobj( i_pcVM, -1, &sqObject );
 
-    sq_pushroottable( i_pcVM );
+    const std::string strName{ GetObjectName( i_pcVM, sqObject ) };
+    if( !strName.empty() )
+    {
+      io_strOutput += '<';
+      io_strOutput += strName;
+      io_strOutput += ">\n";
+    }
 
-    // First, check to see if this is a class/instance variable with a member
-    size_t szDotPosition{ i_strVariable.find( '.' ) };
-    if( szDotPosition != std::string::npos )
+    const auto iSize{ sq_getsize( i_pcVM, -1 ) };
+    if( iSize >= 100 )
     {
-      std::string strClass{ i_strVariable.substr( 0, szDotPosition ) };
-      std::string strMember{ i_strVariable.substr( szDotPosition + 1 ) };
+      // Large containers are browsed a page at a time by expanding them instead
+      io_strOutput += '<';
+      AppendInteger( iSize, false, io_strOutput );
+      io_strOutput += " entries, expand to browse>";
+      return;
+    }
 
-      // Fetch the class/instance from the root table
-      sq_pushstring( i_pcVM, _SC( strClass.c_str() ), -1 );
-      if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
-      {
-        sq_getstackobj( i_pcVM, -1, &sqObject );
+#if SORT_VARIABLE_DESCRIPTIONS
+    // Where each entry starts and ends in the output, for sorting after the entries are all written
+    std::vector<std::pair<size_t, size_t>> vEntries;
+#endif
 
-        // Fetch the class/instance member
-        sq_pushstring( i_pcVM, _SC( strMember.c_str() ), -1 );
-        if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
-        {
-          sq_getstackobj( i_pcVM, -1, &sqObject );
-        }
-      }
-      else
+    // Each entry is formatted straight into the output in a single pass over the table
+    bool bFirst{ true };
+
+    sq_pushnull( i_pcVM );
+    while( SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) ) )
+    {
+      const size_t szEntryStart{ io_strOutput.size() };
+      if( !bFirst )
       {
-        // Not found in the root table, so check locals
-        int32_t iIndex{ 0 };
-        const SQChar* strName{ sq_getlocal( i_pcVM, i_iLocalStackLevel, iIndex++ ) };
-        while( strName )
-        {
-          SQObjectType eType{ sq_gettype( i_pcVM, -1 ) };
-          if( ( ( eType == OT_CLASS ) || ( eType == OT_INSTANCE ) ) && ( strClass.compare( strName ) == 0 ) )
-          {
-            // A matching class/instance was found, so try to fetch the member
-            sq_pushstring( i_pcVM, _SC( strMember.c_str() ), -1 );
-            if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
-            {
-              sq_getstackobj( i_pcVM, -1, &sqObject );
-              sq_poptop( i_pcVM );
-            }
+        io_strOutput += '\n';
+      }
 
-            sq_poptop( i_pcVM );
-          }
+#if SORT_VARIABLE_DESCRIPTIONS
+      const size_t szKeyStart{ io_strOutput.size() };
+#endif
 
-          sq_poptop( i_pcVM );
+      AppendVariable( i_pcVM, -2, i_bValuesAsHex, io_strOutput );
+      io_strOutput += ": ";
 
-          strName = sq_getlocal( i_pcVM, i_iLocalStackLevel, iIndex++ );
-        }
-      }
-    }
-    else
-    {
-      // Check the root table
-      sq_pushstring( i_pcVM, _SC( i_strVariable.c_str() ), -1 );
-      if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
+      const size_t szValueStart{ io_strOutput.size() };
+      AppendVariable( i_pcVM, -1, i_bValuesAsHex, io_strOutput );
+
+      if( io_strOutput.size() == szValueStart )
       {
-        sq_getstackobj( i_pcVM, -1, &sqObject );
+        // Entries without a value to show are left out
+        io_strOutput.resize( szEntryStart );
       }
       else
       {
-        // Fetch the const table
-        sq_pushconsttable( i_pcVM );
-        sq_getstackobj( i_pcVM, -1, &sqObject );
-        sq_pop( i_pcVM, 1 );
-
-        // Push the const table and desired string
-        sq_pushobject( i_pcVM, sqObject );
-        sq_pushstring( i_pcVM, _SC( i_strVariable.c_str() ), -1 );
+        bFirst = false;
 
-        // Fetch the result
-        sq_get( i_pcVM, -2 );
-        sq_getstackobj( i_pcVM, -1, &sqObject );
-        sq_pop( i_pcVM, 2 );
+#if SORT_VARIABLE_DESCRIPTIONS
+        vEntries.emplace_back( szKeyStart, io_strOutput.size() );
+#endif
       }
+
+      // Pop the key and value
+      sq_pop( i_pcVM, 2 );
     }
 
-    sq_settop( i_pcVM, iTop );
+    // Pop the iterator
+    sq_poptop( i_pcVM );
+
+#if SORT_VARIABLE_DESCRIPTIONS
+    if( vEntries.size() > 1 )
+    {
+      // Only the entry positions are sorted, and the entries are then copied once into their new order
+      const size_t szFirstEntry{ vEntries.front().first };
+      const std::string_view strOutput{ io_strOutput };
+      std::sort( vEntries.begin(), vEntries.end(),
+                 [&strOutput]( const std::pair<size_t, size_t>& i_rcLHS, const std::pair<size_t, size_t>& i_rcRHS )
+                 {
+                   return strOutput.substr( i_rcLHS.first, i_rcLHS.second - i_rcLHS.first ) <
+                          strOutput.substr( i_rcRHS.first, i_rcRHS.second - i_rcRHS.first );
+                 } );
 
-    return sqObject;
+      std::string strSorted;
+      strSorted.reserve( io_strOutput.size() - szFirstEntry );
+      for( const auto& iter : vEntries )
+      {
+        if( !strSorted.empty() )
+        {
+          strSorted += '\n';
+        }
+
+        strSorted.append( strOutput.substr( iter.first, iter.second - iter.first ) );
+      }
+
+      io_strOutput.replace( szFirstEntry, std::string::npos, strSorted );
+    }
+#endif
+
+#if DEBUG_OUTPUT
+    SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
+    assert( iTopBegin == iTopEnd );
+#endif
   }
 
 
-  std::string FormatVariable( HSQUIRRELVM i_pcVM, const SQInteger i_iIndex, bool i_bValuesAsHex )
+  void AppendVariable( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex, std::string& io_strOutput )
   {
-    std::string strVariable;
-
 #if DEBUG_OUTPUT
     SQInteger iTopBegin{ sq_gettop( i_pcVM ) };
 #endif
@@ -324,18 +370,15 @@ namespace rumDebugUtility
       {
         SQBool b;
         sq_getbool( i_pcVM, i_iIndex, &b );
-        strVariable = b ? "true" : "false";
+        io_strOutput += b ? "true" : "false";
         break;
       }
 
       case OT_ARRAY:
       case OT_CLASS:
-      case OT_TABLE:
-        strVariable = BuildTableDescription( i_pcVM, i_bValuesAsHex );
-        break;
-
       case OT_INSTANCE:
-        strVariable = BuildInstanceDescription( i_pcVM, i_bValuesAsHex );
+      case OT_TABLE:
+        AppendContainerDescription( i_pcVM, i_iIndex, i_bValuesAsHex, io_strOutput );
         break;
 
       case OT_CLOSURE:
@@ -345,20 +388,22 @@ namespace rumDebugUtility
           const ::SQChar* strVal = nullptr;
           if( SQ_SUCCEEDED( sq_getstring( i_pcVM, i_iIndex, &strVal ) ) )
           {
-            strVariable = strVal ? strVal : "<anonymous closure>";
+            io_strOutput += strVal ? strVal : "<anonymous closure>";
             sq_poptop( i_pcVM );
           }
         }
         else
         {
-          strVariable = "<invalid closure>";
+          io_strOutput += "<invalid closure>";
         }
 
         SQUnsignedInteger iParams{ 0 };
         SQUnsignedInteger iFreeVars{ 0 };
         if( SQ_SUCCEEDED( sq_getclosureinfo( i_pcVM, i_iIndex, &iParams, &iFreeVars ) ) )
         {
-          strVariable += "(" + std::to_string( iParams ) + " params)";
+          io_strOutput += '(';
+          AppendInteger( static_cast<SQInteger>( iParams ), false, io_strOutput );
+          io_strOutput += " params)";
         }
         break;
       }
@@ -367,7 +412,7 @@ namespace rumDebugUtility
       {
         SQFloat f;
         sq_getfloat( i_pcVM, i_iIndex, &f );
-        strVariable = std::to_string( f );
+        AppendFloat( f, io_strOutput );
         break;
       }
 
@@ -375,49 +420,26 @@ namespace rumDebugUtility
       {
         SQInteger i;
         sq_getinteger( i_pcVM, i_iIndex, &i );
-        if( i_bValuesAsHex )
-        {
-          static char strHighBuffer[20] = { '0', 'x', '\0' };
-          static char strLowBuffer[20] = { '\0' };
-
-#if _WIN64 || __x86_64__ || __ppc64__
-          if( sizeof( SQInteger ) == sizeof( int64_t ) && ( i >> 32 ) > 0 )
-          {
-            _itoa_s( static_cast<int32_t>( i >> 32 ), &strHighBuffer[2], 18, 16 );
-            strVariable = strHighBuffer;
-            strVariable += _itoa_s( static_cast<int32_t>( i ), &strLowBuffer[0], 20, 16 );
-          }
-          else
-          {
-            _itoa_s( static_cast<int32_t>( i ), &strHighBuffer[2], 18, 16 );
-            strVariable = strHighBuffer;
-          }
-#else
-          _itoa_s( static_cast<int32_t>( i ), &strHighBuffer[2], 18, 16 );
-          strVariable = strHighBuffer;
-#endif
-        }
-        else
-        {
-          strVariable = std::to_string( i );
-        }
+        AppendInteger( i, i_bValuesAsHex, io_strOutput );
         break;
       }
 
       case OT_NULL:
-        strVariable = "null";
+        io_strOutput += "null";
         break;
 
       case OT_STRING:
       {
         const SQChar* s;
         sq_getstring( i_pcVM, i_iIndex, &s );
-        strVariable = s;
+        io_strOutput += s;
         break;
       }
 
       default:
-        strVariable = '<' + GetTypeName( eType ) + '>';
+        io_strOutput += '<';
+        io_strOutput += GetTypeName( eType );
+        io_strOutput += '>';
         break;
     }
 
@@ -425,101 +447,513 @@ namespace rumDebugUtility
     SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
     assert( iTopBegin == iTopEnd );
 #endif
-
-    return strVariable;
   }
 
 
-  std::string FormatVariable( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject, bool i_bValuesAsHex )
+  void AppendVariableSummary( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex, std::string& io_strOutput )
   {
-#if DEBUG_OUTPUT
-    SQInteger iTopBegin{ sq_gettop( i_pcVM ) };
-#endif
+    HSQOBJECT sqObject;
+    sq_getstackobj( i_pcVM, i_iIndex, &sqObject );
 
-    sq_pushobject( i_pcVM, i_sqObject );
-    std::string strVariable{ FormatVariable( i_pcVM, -1, i_bValuesAsHex ) };
-    sq_poptop( i_pcVM );
+    switch( sq_type( sqObject ) )
+    {
+      case OT_ARRAY:
+        io_strOutput += '[';
+        AppendInteger( sq_getsize( i_pcVM, i_iIndex ), false, io_strOutput );
+        io_strOutput += " items]";
+        break;
 
-#if DEBUG_OUTPUT
-    SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
-    assert( iTopBegin == iTopEnd );
-#endif
+      case OT_TABLE:
+      {
+        const std::string strName{ GetObjectName( i_pcVM, sqObject ) };
+        if( !strName.empty() )
+        {
+          io_strOutput += '<';
+          io_strOutput += strName;
+          io_strOutput += "> ";
+        }
 
-    return strVariable;
-  }
+        io_strOutput += '{';
+        AppendInteger( sq_getsize( i_pcVM, i_iIndex ), false, io_strOutput );
+        io_strOutput += " slots}";
+        break;
+      }
 
+      case OT_CLASS:
+      {
+        const std::string strName{ GetObjectName( i_pcVM, sqObject ) };
+        io_strOutput += '<';
+        io_strOutput += strName.empty() ? std::string_view( "class" ) : std::string_view( strName );
+        io_strOutput += '>';
+        break;
+      }
 
-  std::string GetObjectName( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject )
-  {
-    // TODO - the hash value for found entries could be cached, but performance isn't really a requirement here
+      case OT_INSTANCE:
+      {
+        std::string strName;
+        if( SQ_SUCCEEDED( sq_getclass( i_pcVM, i_iIndex ) ) )
+        {
+          HSQOBJECT sqClass;
+          sq_getstackobj( i_pcVM, -1, &sqClass );
+          strName = GetObjectName( i_pcVM, sqClass );
+          sq_poptop( i_pcVM );
+        }
 
-    if( !( sq_isarray( i_sqObject ) || sq_istable( i_sqObject ) || sq_isclass( i_sqObject ) ||
-           sq_isinstance( i_sqObject ) ) )
-    {
-      return "";
+        io_strOutput += '<';
+        io_strOutput += strName.empty() ? std::string_view( "instance" ) : std::string_view( strName );
+        io_strOutput += strName.empty() ? ">" : "> instance";
+        break;
+      }
+
+      default:
+        AppendVariable( i_pcVM, i_iIndex, i_bValuesAsHex, io_strOutput );
+        break;
     }
+  }
 
-#if DEBUG_OUTPUT
-    SQInteger iTop{ sq_gettop( i_pcVM ) };
-#endif
 
-    std::string strName;
+  std::string BuildInstanceDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex )
+  {
+    std::string strDesc;
+    AppendInstanceDescription( i_pcVM, i_bValuesAsHex, strDesc );
+    return strDesc;
+  }
 
-    sq_pushobject( i_pcVM, i_sqObject );
-    const auto iObjectHash{ sq_gethash( i_pcVM, -1 ) };
-    sq_poptop( i_pcVM );
 
-    sq_pushroottable( i_pcVM );
-    const auto iRootTableHash{ sq_gethash( i_pcVM, -1 ) };
+  std::string BuildMessageExpression( const std::string& i_strTemplate )
+  {
+    // Literal text becomes verbatim strings and each {expression} is concatenated in parentheses. Starting from an
+    // empty string converts every operand to a string rather than adding them.
+    std::string strExpression{ "\"\"" };
+    std::string strLiteral;
 
-    // Early out if this is the root table
-    if( iRootTableHash == iObjectHash )
+    const auto AppendLiteral{ [&]()
     {
-      sq_poptop( i_pcVM );
+      if( !strLiteral.empty() )
+      {
+        strExpression += " + @\"";
+        for( const char cChar : strLiteral )
+        {
+          // Quotes are doubled in verbatim strings
+          if( '"' == cChar )
+          {
+            strExpression += '"';
+          }
 
-#if DEBUG_OUTPUT
-      SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
-      assert( iTop == iTopEnd );
-#endif
+          strExpression += cChar;
+        }
+
+        strExpression += '"';
+        strLiteral.clear();
+      }
+    } };
+
+    const size_t szLength{ i_strTemplate.length() };
+    size_t szIndex{ 0 };
+    while( szIndex < szLength )
+    {
+      const char cChar{ i_strTemplate[szIndex] };
+      if( ( '{' == cChar || '}' == cChar ) && ( szIndex + 1 < szLength ) && ( i_strTemplate[szIndex + 1] == cChar ) )
+      {
+        // Doubled braces are literal braces
+        strLiteral += cChar;
+        szIndex += 2;
+        continue;
+      }
+
+      if( '{' == cChar )
+      {
+        // Find the matching closing brace, allowing for braces within the expression
+        int32_t iDepth{ 1 };
+        size_t szEnd{ szIndex + 1 };
+        for( ; szEnd < szLength; ++szEnd )
+        {
+          if( '{' == i_strTemplate[szEnd] )
+          {
+            ++iDepth;
+          }
+          else if( '}' == i_strTemplate[szEnd] && 0 == --iDepth )
+          {
+            break;
+          }
+        }
+
+        if( szEnd < szLength )
+        {
+          AppendLiteral();
+          strExpression += " + ( " + i_strTemplate.substr( szIndex + 1, szEnd - szIndex - 1 ) + " )";
+          szIndex = szEnd + 1;
+          continue;
+        }
+
+        // An unterminated brace is kept as literal text
+      }
 
-      return "<RootTable>";
+      strLiteral += cChar;
+      ++szIndex;
     }
 
-    // Push iteration index
+    AppendLiteral();
+
+    return strExpression;
+  }
+
+
+  void BuildObjectNameIndex( HSQUIRRELVM i_pcVM )
+  {
+    g_mapObjectNames.clear();
+
+    const auto IndexTable{ [i_pcVM]()
+    {
+      sq_pushnull( i_pcVM );
+      while( SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) ) )
+      {
+        const SQObjectType eType{ sq_gettype( i_pcVM, -1 ) };
+        if( ( OT_ARRAY == eType || OT_TABLE == eType || OT_CLASS == eType || OT_INSTANCE == eType ) &&
+            OT_STRING == sq_gettype( i_pcVM, -2 ) )
+        {
+          const SQChar* strKey{ nullptr };
+          sq_getstring( i_pcVM, -2, &strKey );
+
+          // The first entry found for an object names it
+          g_mapObjectNames.emplace( sq_gethash( i_pcVM, -1 ), strKey );
+        }
+
+        sq_pop( i_pcVM, 2 );
+      }
+
+      // Pop the iterator and the table
+      sq_pop( i_pcVM, 2 );
+    } };
+
+    sq_pushroottable( i_pcVM );
+    g_mapObjectNames.emplace( sq_gethash( i_pcVM, -1 ), "<RootTable>" );
+    IndexTable();
+
+    // Constants can't shadow root table entries, but enums are only found here
+    sq_pushconsttable( i_pcVM );
+    IndexTable();
+
+    g_pcObjectNameVM = i_pcVM;
+    g_uiObjectNameIndexEpoch = g_uiObjectNameEpoch.load( std::memory_order_relaxed );
+    g_bObjectNamesIndexed = true;
+  }
+
+
+  std::string BuildTableDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex )
+  {
+    std::string strDesc;
+    AppendTableDescription( i_pcVM, i_bValuesAsHex, strDesc );
+    return strDesc;
+  }
+
+
+  bool CompileExpression( HSQUIRRELVM i_pcVM, rumDebugExpression& io_rcExpression, uint32_t i_uiStackLevel )
+  {
+    ReleaseExpression( i_pcVM, io_rcExpression );
+
+    io_rcExpression.m_vLocalNames.clear();
+    io_rcExpression.m_strError.clear();
+
     SQInteger iIndex{ 0 };
+    const SQChar* strName{ sq_getlocal( i_pcVM, i_uiStackLevel, iIndex++ ) };
+    while( strName )
+    {
+      io_rcExpression.m_vLocalNames.emplace_back( strName );
+      sq_poptop( i_pcVM );
+
+      strName = sq_getlocal( i_pcVM, i_uiStackLevel, iIndex++ );
+    }
+
+    // Every local after 'this' becomes a parameter of the same name. Locals that can't be named as parameters, such as
+    // the hidden foreach iterators or a repeated name from a nested scope, are still passed under a placeholder name.
+    const auto& rcvLocalNames{ io_rcExpression.m_vLocalNames };
+
+    std::string strParameters;
+    for( size_t i{ 1 }; i < rcvLocalNames.size(); ++i )
+    {
+      if( i > 1 )
+      {
+        strParameters += ", ";
+      }
+
+      const bool bRepeated{ std::find( rcvLocalNames.begin() + 1, rcvLocalNames.begin() + i, rcvLocalNames[i] ) !=
+                            rcvLocalNames.begin() + i };
+      if( bRepeated || !IsIdentifier( rcvLocalNames[i] ) )
+      {
+        strParameters += "__unnamed" + std::to_string( i );
+      }
+      else
+      {
+        strParameters += rcvLocalNames[i];
+      }
+    }
+
+    // The expression is closed on its own line so that a trailing comment can't swallow the closing tokens
+    const std::string strSource{ "return function( " + strParameters + " ) { return ( " +
+                                 io_rcExpression.m_strExpression + "\n); }" };
+
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
+
+    bool bSuccess{ SQ_SUCCEEDED( sq_compilebuffer( i_pcVM, strSource.c_str(),
+                                                   static_cast<SQInteger>( strSource.length() ), _SC( "expression" ),
+                                                   SQFalse ) ) };
+    if( bSuccess )
+    {
+      // Running the compiled buffer returns the expression closure
+      sq_pushroottable( i_pcVM );
+      bSuccess = SQ_SUCCEEDED( sq_call( i_pcVM, 1, SQTrue, SQFalse ) );
+    }
 
-    bool bSuccess{ false };
+    if( bSuccess )
+    {
+      sq_getstackobj( i_pcVM, -1, &io_rcExpression.m_sqClosure );
+      sq_addref( i_pcVM, &io_rcExpression.m_sqClosure );
+      io_rcExpression.m_bCompiled = true;
+    }
+    else
+    {
+      io_rcExpression.m_strError = GetLastError( i_pcVM );
+      io_rcExpression.m_bFailed = true;
+    }
+
+    sq_settop( i_pcVM, iTop );
 
-    do
+    return bSuccess;
+  }
+
+
+  rumDebugValueFingerprint ComputeValueFingerprint( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex )
+  {
+    HSQOBJECT sqObject;
+    sq_getstackobj( i_pcVM, i_iIndex, &sqObject );
+
+    rumDebugValueFingerprint cFingerprint;
+    cFingerprint.m_uiType = static_cast<uint32_t>( sq_type( sqObject ) );
+    cFingerprint.m_bHex = i_bValuesAsHex;
+
+    switch( sq_type( sqObject ) )
     {
-      sq_pushinteger( i_pcVM, iIndex );
+      case OT_BOOL:
+      {
+        SQBool bValue{ SQFalse };
+        sq_getbool( i_pcVM, i_iIndex, &bValue );
+        cFingerprint.m_uiValue = bValue;
+        break;
+      }
+
+      case OT_INTEGER:
+      {
+        SQInteger iValue{ 0 };
+        sq_getinteger( i_pcVM, i_iIndex, &iValue );
+        cFingerprint.m_uiValue = static_cast<uint64_t>( iValue );
+        break;
+      }
+
+      case OT_FLOAT:
+      {
+        SQFloat fValue{ 0 };
+        sq_getfloat( i_pcVM, i_iIndex, &fValue );
+        memcpy( &cFingerprint.m_uiValue, &fValue, sizeof( fValue ) );
+        break;
+      }
+
+      case OT_NULL:
+        break;
 
-      // Iterate
-      bSuccess = SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) );
-      if( bSuccess )
+      case OT_STRING:
       {
-        // The object value is at position -1, so get its hash
-        const auto iIterHash{ sq_gethash( i_pcVM, -1 ) };
-        if( iObjectHash == iIterHash )
+        // A string can be freed and another allocated in its place between pauses, so its identity isn't enough.
+        // Squirrel's own hash only reads the start of long strings, so the whole string is hashed (FNV-1a).
+        const SQChar* strValue{ nullptr };
+        sq_getstring( i_pcVM, i_iIndex, &strValue );
+        const SQInteger iSize{ sq_getsize( i_pcVM, i_iIndex ) };
+
+        uint64_t uiHash{ 14695981039346656037ULL };
+        for( SQInteger i{ 0 }; i < iSize; ++i )
         {
-          // Get the entry's key
-          HSQOBJECT sqKey;
-          sq_getstackobj( i_pcVM, -2, &sqKey );
-          strName = sq_objtostring( &sqKey );
+          uiHash = ( uiHash ^ static_cast<std::make_unsigned_t<SQChar>>( strValue[i] ) ) * 1099511628211ULL;
         }
 
-        // Next iteration index
-        sq_getinteger( i_pcVM, -3, &iIndex );
+        cFingerprint.m_uiValue = uiHash;
+        cFingerprint.m_uiSize = static_cast<uint32_t>( iSize );
+        break;
+      }
 
-        // Pop the key and value
-        sq_pop( i_pcVM, 2 );
+      case OT_ARRAY:
+      case OT_TABLE:
+        // Containers are summarized by their size, and are changed in place, so their first members are hashed too
+        cFingerprint.m_uiSize = static_cast<uint32_t>( sq_getsize( i_pcVM, i_iIndex ) );
+        cFingerprint.m_uiValue = HashMembers( i_pcVM, i_iIndex,
+                                              reinterpret_cast<uintptr_t>( sqObject._unVal.pRefCounted ) );
+        break;
+
+      case OT_INSTANCE:
+        cFingerprint.m_uiValue = HashMembers( i_pcVM, i_iIndex,
+                                              reinterpret_cast<uintptr_t>( sqObject._unVal.pRefCounted ) );
+        break;
+
+      default:
+        cFingerprint.m_uiValue = reinterpret_cast<uintptr_t>( sqObject._unVal.pRefCounted );
+        break;
+    }
+
+    return cFingerprint;
+  }
+
+
+  SQRESULT EvaluateExpression( HSQUIRRELVM i_pcVM, rumDebugExpression& io_rcExpression, uint32_t i_uiStackLevel,
+                               uint32_t i_uiTimeBudgetMS )
+  {
+    if( io_rcExpression.m_bFailed )
+    {
+      return SQ_ERROR;
+    }
+
+    // The closure's parameters must line up with the frame's locals, which vary from frame to frame and line to line
+    bool bLocalsMatch{ io_rcExpression.m_bCompiled };
+    SQInteger iNumLocals{ 0 };
+    while( bLocalsMatch )
+    {
+      const SQChar* strName{ sq_getlocal( i_pcVM, i_uiStackLevel, iNumLocals ) };
+      if( nullptr == strName )
+      {
+        bLocalsMatch = static_cast<size_t>( iNumLocals ) == io_rcExpression.m_vLocalNames.size();
+        break;
       }
 
-      // Pop the iterator index
       sq_poptop( i_pcVM );
-    } while( bSuccess && strName.empty() );
 
-    // Pop the root table
+      bLocalsMatch = static_cast<size_t>( iNumLocals ) < io_rcExpression.m_vLocalNames.size() &&
+                     io_rcExpression.m_vLocalNames[iNumLocals].compare( strName ) == 0;
+      ++iNumLocals;
+    }
+
+    if( !bLocalsMatch && !CompileExpression( i_pcVM, io_rcExpression, i_uiStackLevel ) )
+    {
+      return SQ_ERROR;
+    }
+
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
+
+    sq_pushobject( i_pcVM, io_rcExpression.m_sqClosure );
+
+    // Pass the frame's locals in stack order, starting with 'this'
+    SQInteger iNumParams{ 0 };
+    while( sq_getlocal( i_pcVM, i_uiStackLevel, iNumParams ) )
+    {
+      ++iNumParams;
+    }
+
+    if( 0 == iNumParams )
+    {
+      // There is no script frame at this level
+      sq_pushroottable( i_pcVM );
+      ++iNumParams;
+    }
+
+    const auto tStart{ std::chrono::steady_clock::now() };
+    const bool bSuccess{ SQ_SUCCEEDED( sq_call( i_pcVM, iNumParams, SQTrue, SQFalse ) ) };
+    const auto tElapsed{ std::chrono::steady_clock::now() - tStart };
+
+    if( !bSuccess )
+    {
+      io_rcExpression.m_strError = GetLastError( i_pcVM );
+      sq_settop( i_pcVM, iTop );
+      return SQ_ERROR;
+    }
+
+    // Squirrel's API has no way to interrupt a running call, so the budget can only be checked once the call returns.
+    // An expression that overran it is kept from running again, but one that never returns blocks the VM's thread.
+    if( tElapsed > std::chrono::milliseconds( i_uiTimeBudgetMS ) )
+    {
+      io_rcExpression.m_strError = "Exceeded the " + std::to_string( i_uiTimeBudgetMS ) + "ms time budget";
+      io_rcExpression.m_bFailed = true;
+      sq_settop( i_pcVM, iTop );
+      return SQ_ERROR;
+    }
+
+    // Leave only the result on the stack
+    sq_remove( i_pcVM, -2 );
+
+    return SQ_OK;
+  }
+
+
+  std::string FormatVariable( HSQUIRRELVM i_pcVM, const SQInteger i_iIndex, bool i_bValuesAsHex )
+  {
+    std::string strVariable;
+    AppendVariable( i_pcVM, i_iIndex, i_bValuesAsHex, strVariable );
+    return strVariable;
+  }
+
+
+  std::string FormatVariable( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject, bool i_bValuesAsHex )
+  {
+#if DEBUG_OUTPUT
+    SQInteger iTopBegin{ sq_gettop( i_pcVM ) };
+#endif
+
+    sq_pushobject( i_pcVM, i_sqObject );
+    std::string strVariable{ FormatVariable( i_pcVM, -1, i_bValuesAsHex ) };
+    sq_poptop( i_pcVM );
+
+#if DEBUG_OUTPUT
+    SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
+    assert( iTopBegin == iTopEnd );
+#endif
+
+    return strVariable;
+  }
+
+
+  std::string FormatVariableSummary( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex )
+  {
+    std::string strSummary;
+    AppendVariableSummary( i_pcVM, i_iIndex, i_bValuesAsHex, strSummary );
+    return strSummary;
+  }
+
+
+  std::string GetLastError( HSQUIRRELVM i_pcVM )
+  {
+    std::string strError{ "Unknown error" };
+
+    sq_getlasterror( i_pcVM );
+
+    const SQChar* strMessage{ nullptr };
+    if( SQ_SUCCEEDED( sq_getstring( i_pcVM, -1, &strMessage ) ) )
+    {
+      strError = strMessage;
+    }
+
+    sq_poptop( i_pcVM );
+
+    return strError;
+  }
+
+
+  std::string GetObjectName( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject )
+  {
+    if( !( sq_isarray( i_sqObject ) || sq_istable( i_sqObject ) || sq_isclass( i_sqObject ) ||
+           sq_isinstance( i_sqObject ) ) )
+    {
+      return "";
+    }
+
+#if DEBUG_OUTPUT
+    SQInteger iTop{ sq_gettop( i_pcVM ) };
+#endif
+
+    // The root and const tables are only indexed once per pause rather than searched for every object formatted
+    if( !g_bObjectNamesIndexed || g_pcObjectNameVM != i_pcVM ||
+        g_uiObjectNameIndexEpoch != g_uiObjectNameEpoch.load( std::memory_order_relaxed ) )
+    {
+      BuildObjectNameIndex( i_pcVM );
+    }
+
+    sq_pushobject( i_pcVM, i_sqObject );
+    const auto iObjectHash{ sq_gethash( i_pcVM, -1 ) };
     sq_poptop( i_pcVM );
 
 #if DEBUG_OUTPUT
@@ -527,7 +961,8 @@ namespace rumDebugUtility
     assert( iTop == iTopEnd );
 #endif
 
-    return strName;
+    const auto& iter{ g_mapObjectNames.find( iObjectHash ) };
+    return iter != g_mapObjectNames.end() ? iter->second : "";
   }
 
 
@@ -564,6 +999,160 @@ namespace rumDebugUtility
   }
 
 
+  uint64_t HashMembers( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, uint64_t i_uiHash )
+  {
+    const auto HashObject{ []( HSQOBJECT i_sqObject, uint64_t& io_uiHash )
+    {
+      uint64_t uiValue{ 0 };
+      switch( sq_type( i_sqObject ) )
+      {
+        case OT_BOOL:
+        case OT_INTEGER:
+          uiValue = static_cast<uint64_t>( i_sqObject._unVal.nInteger );
+          break;
+
+        case OT_FLOAT:
+          memcpy( &uiValue, &i_sqObject._unVal.fFloat, sizeof( i_sqObject._unVal.fFloat ) );
+          break;
+
+        case OT_NULL:
+          break;
+
+        default:
+          uiValue = reinterpret_cast<uintptr_t>( i_sqObject._unVal.pRefCounted );
+          break;
+      }
+
+      // FNV-1a over whole values rather than bytes
+      io_uiHash = ( io_uiHash ^ static_cast<uint64_t>( sq_type( i_sqObject ) ) ) * 1099511628211ULL;
+      io_uiHash = ( io_uiHash ^ uiValue ) * 1099511628211ULL;
+    } };
+
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
+
+    HSQOBJECT sqObject;
+    sq_getstackobj( i_pcVM, i_iIndex, &sqObject );
+    const bool bInstance{ sq_type( sqObject ) == OT_INSTANCE };
+
+    // An instance's members are iterated through its class, while their values are fetched from the instance
+    sq_pushobject( i_pcVM, sqObject );
+    if( bInstance && SQ_FAILED( sq_getclass( i_pcVM, -1 ) ) )
+    {
+      sq_settop( i_pcVM, iTop );
+      return i_uiHash;
+    }
+
+    const SQInteger iIterable{ sq_gettop( i_pcVM ) };
+
+    uint64_t uiHash{ 14695981039346656037ULL ^ i_uiHash };
+
+    uint32_t uiNumMembers{ 0 };
+    sq_pushnull( i_pcVM );
+    while( uiNumMembers < FINGERPRINT_MAX_MEMBERS && SQ_SUCCEEDED( sq_next( i_pcVM, iIterable ) ) )
+    {
+      HSQOBJECT sqKey;
+      sq_getstackobj( i_pcVM, -2, &sqKey );
+
+      if( bInstance )
+      {
+        // Replace the class's default value with the instance's value
+        sq_poptop( i_pcVM );
+        sq_pushobject( i_pcVM, sqObject );
+        sq_pushobject( i_pcVM, sqKey );
+        if( SQ_FAILED( sq_rawget( i_pcVM, -2 ) ) )
+        {
+          sq_pushnull( i_pcVM );
+        }
+      }
+
+      HSQOBJECT sqValue;
+      sq_getstackobj( i_pcVM, -1, &sqValue );
+
+      HashObject( sqKey, uiHash );
+      HashObject( sqValue, uiHash );
+
+      ++uiNumMembers;
+
+      // Pop everything but the iterator
+      sq_settop( i_pcVM, iIterable + 1 );
+    }
+
+    sq_settop( i_pcVM, iTop );
+
+    return uiHash;
+  }
+
+
+  bool IsExecutableLine( std::string_view i_strLine, bool& io_bInBlockComment )
+  {
+    // Lines made up of only these characters don't execute anything on their own
+    constexpr std::string_view strPunctuation{ "{}();," };
+
+    bool bExecutable{ false };
+
+    for( size_t szIndex{ 0 }; szIndex < i_strLine.size(); ++szIndex )
+    {
+      const char cChar{ i_strLine[szIndex] };
+      const char cNextChar{ szIndex + 1 < i_strLine.size() ? i_strLine[szIndex + 1] : '\0' };
+
+      if( io_bInBlockComment )
+      {
+        if( '*' == cChar && '/' == cNextChar )
+        {
+          io_bInBlockComment = false;
+          ++szIndex;
+        }
+      }
+      else if( '/' == cChar && '*' == cNextChar )
+      {
+        io_bInBlockComment = true;
+        ++szIndex;
+      }
+      else if( ( '/' == cChar && '/' == cNextChar ) || '#' == cChar )
+      {
+        // The rest of the line is a comment
+        break;
+      }
+      else if( '"' == cChar || '\'' == cChar )
+      {
+        // Skip the literal so that comment markers inside it aren't mistaken for comments
+        for( ++szIndex; szIndex < i_strLine.size() && i_strLine[szIndex] != cChar; ++szIndex )
+        {
+          if( '\\' == i_strLine[szIndex] )
+          {
+            ++szIndex;
+          }
+        }
+
+        bExecutable = true;
+      }
+      else if( !std::isspace( static_cast<unsigned char>( cChar ) ) &&
+               std::string_view::npos == strPunctuation.find( cChar ) )
+      {
+        bExecutable = true;
+      }
+    }
+
+    return bExecutable;
+  }
+
+
+  bool IsIdentifier( const std::string& i_strToken )
+  {
+    if( i_strToken.empty() || std::isdigit( static_cast<unsigned char>( i_strToken[0] ) ) )
+    {
+      return false;
+    }
+
+    const bool bValidChars{ std::all_of( i_strToken.begin(), i_strToken.end(), []( char i_cChar )
+      {
+        return std::isalnum( static_cast<unsigned char>( i_cChar ) ) || '_' == i_cChar;
+      } ) };
+
+    return bValidChars && !IsReservedWord( i_strToken );
+  }
+
+
   bool IsOperator( const std::string& i_strToken )
   {
     static std::vector<std::string> vOperators
@@ -606,4 +1195,360 @@ namespace rumDebugUtility
     auto eRawType{ _RAW_TYPE( i_eObjectType ) };
     return( eRawType < OT_NULL && eRawType > _RT_OUTER );
   }
+
+
+  bool ParseAccessPath( const std::string& i_strSource, rumDebugAccessPath& o_rcPath )
+  {
+    o_rcPath = rumDebugAccessPath();
+
+    const char* pcPos{ i_strSource.c_str() };
+    const char* pcEnd{ pcPos + i_strSource.size() };
+
+    const auto SkipSpaces{ [&pcPos, pcEnd]()
+      {
+        while( pcPos < pcEnd && std::isspace( static_cast<unsigned char>( *pcPos ) ) )
+        {
+          ++pcPos;
+        }
+      } };
+
+    // Returns the identifier at the current position, or an empty string if there isn't one
+    const auto ParseIdentifier{ [&pcPos, pcEnd]()
+      {
+        const char* pcStart{ pcPos };
+        if( pcPos < pcEnd && ( std::isalpha( static_cast<unsigned char>( *pcPos ) ) || '_' == *pcPos ) )
+        {
+          while( pcPos < pcEnd && ( std::isalnum( static_cast<unsigned char>( *pcPos ) ) || '_' == *pcPos ) )
+          {
+            ++pcPos;
+          }
+        }
+
+        return std::string( pcStart, pcPos );
+      } };
+
+    SkipSpaces();
+
+    if( pcEnd - pcPos >= 2 && ':' == pcPos[0] && ':' == pcPos[1] )
+    {
+      o_rcPath.m_bRootTable = true;
+      pcPos += 2;
+    }
+
+    o_rcPath.m_strRoot = ParseIdentifier();
+    if( o_rcPath.m_strRoot.empty() )
+    {
+      return false;
+    }
+
+    // Of the reserved words, only this can start a path
+    if( IsReservedWord( o_rcPath.m_strRoot ) &&
+        ( o_rcPath.m_bRootTable || o_rcPath.m_strRoot.compare( "this" ) != 0 ) )
+    {
+      return false;
+    }
+
+    SkipSpaces();
+
+    while( pcPos < pcEnd )
+    {
+      rumDebugAccessPath::Key cKey;
+
+      if( '.' == *pcPos )
+      {
+        ++pcPos;
+        SkipSpaces();
+
+        cKey.m_strKey = ParseIdentifier();
+        if( cKey.m_strKey.empty() )
+        {
+          return false;
+        }
+      }
+      else if( '[' == *pcPos )
+      {
+        ++pcPos;
+        SkipSpaces();
+
+        if( pcPos < pcEnd && '"' == *pcPos )
+        {
+          // A string index, which may contain the usual escape sequences
+          ++pcPos;
+          while( pcPos < pcEnd && *pcPos != '"' )
+          {
+            char cChar{ *pcPos++ };
+            if( '\\' == cChar && pcPos < pcEnd )
+            {
+              cChar = *pcPos++;
+              switch( cChar )
+              {
+                case 'n': cChar = '\n'; break;
+                case 'r': cChar = '\r'; break;
+                case 't': cChar = '\t'; break;
+                case '0': cChar = '\0'; break;
+                default: break;
+              }
+            }
+
+            cKey.m_strKey.push_back( cChar );
+          }
+
+          if( pcPos == pcEnd )
+          {
+            return false;
+          }
+
+          ++pcPos;
+        }
+        else
+        {
+          // An integer index in decimal or hex
+          const bool bNegative{ pcPos < pcEnd && '-' == *pcPos };
+          if( bNegative )
+          {
+            ++pcPos;
+          }
+
+          int iBase{ 10 };
+          if( pcEnd - pcPos > 2 && '0' == pcPos[0] && ( 'x' == pcPos[1] || 'X' == pcPos[1] ) )
+          {
+            iBase = 16;
+            pcPos += 2;
+          }
+
+          uint64_t uiKey{ 0 };
+          const auto cResult{ std::from_chars( pcPos, pcEnd, uiKey, iBase ) };
+          if( cResult.ec != std::errc() )
+          {
+            return false;
+          }
+
+          pcPos = cResult.ptr;
+
+          cKey.m_iKey = static_cast<int64_t>( bNegative ? 0 - uiKey : uiKey );
+          cKey.m_bInteger = true;
+        }
+
+        SkipSpaces();
+
+        if( pcPos == pcEnd || *pcPos != ']' )
+        {
+          return false;
+        }
+
+        ++pcPos;
+      }
+      else
+      {
+        return false;
+      }
+
+      o_rcPath.m_vKeys.push_back( std::move( cKey ) );
+
+      SkipSpaces();
+    }
+
+    o_rcPath.m_bValid = true;
+
+    return true;
+  }
+
+
+  bool PushAccessPathRoot( HSQUIRRELVM i_pcVM, rumDebugAccessPath& io_rcPath, uint32_t i_uiStackLevel )
+  {
+    const std::string& strRoot{ io_rcPath.m_strRoot };
+
+    if( !io_rcPath.m_bRootTable )
+    {
+      // Check the local the root was last found at before searching the rest of the frame's locals
+      if( io_rcPath.m_iLocalIndex >= 0 )
+      {
+        const SQChar* strName{ sq_getlocal( i_pcVM, i_uiStackLevel, io_rcPath.m_iLocalIndex ) };
+        if( strName )
+        {
+          if( strRoot.compare( strName ) == 0 )
+          {
+            return true;
+          }
+
+          sq_poptop( i_pcVM );
+        }
+      }
+
+      int32_t iIndex{ 0 };
+      const SQChar* strName{ sq_getlocal( i_pcVM, i_uiStackLevel, iIndex ) };
+      while( strName )
+      {
+        if( iIndex != io_rcPath.m_iLocalIndex && strRoot.compare( strName ) == 0 )
+        {
+          io_rcPath.m_iLocalIndex = iIndex;
+          return true;
+        }
+
+        sq_poptop( i_pcVM );
+
+        strName = sq_getlocal( i_pcVM, i_uiStackLevel, ++iIndex );
+      }
+
+      io_rcPath.m_iLocalIndex = -1;
+    }
+
+    // Check the root table
+    sq_pushroottable( i_pcVM );
+    sq_pushobject( i_pcVM, io_rcPath.m_sqRoot );
+    if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
+    {
+      sq_remove( i_pcVM, -2 );
+      return true;
+    }
+
+    sq_poptop( i_pcVM );
+
+    if( io_rcPath.m_bRootTable )
+    {
+      return false;
+    }
+
+    // Check the const table
+    sq_pushconsttable( i_pcVM );
+    sq_pushobject( i_pcVM, io_rcPath.m_sqRoot );
+    if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
+    {
+      sq_remove( i_pcVM, -2 );
+      return true;
+    }
+
+    sq_poptop( i_pcVM );
+
+    // Finally, try it as a member of this, which is always the frame's first local
+    const SQChar* strThis{ sq_getlocal( i_pcVM, i_uiStackLevel, 0 ) };
+    if( strThis )
+    {
+      if( strcmp( strThis, "this" ) == 0 )
+      {
+        sq_pushobject( i_pcVM, io_rcPath.m_sqRoot );
+        if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) )
+        {
+          sq_remove( i_pcVM, -2 );
+          return true;
+        }
+      }
+
+      sq_poptop( i_pcVM );
+    }
+
+    return false;
+  }
+
+
+  void PushString( HSQUIRRELVM i_pcVM, const std::string& i_strValue )
+  {
+#ifdef SQUNICODE
+    const std::wstring strValue( i_strValue.begin(), i_strValue.end() );
+    sq_pushstring( i_pcVM, strValue.c_str(), static_cast<SQInteger>( strValue.size() ) );
+#else
+    sq_pushstring( i_pcVM, i_strValue.c_str(), static_cast<SQInteger>( i_strValue.size() ) );
+#endif
+  }
+
+
+  void ReleaseAccessPath( HSQUIRRELVM i_pcVM, rumDebugAccessPath& io_rcPath )
+  {
+    if( io_rcPath.m_pcVM != i_pcVM || nullptr == i_pcVM )
+    {
+      return;
+    }
+
+    sq_release( i_pcVM, &io_rcPath.m_sqRoot );
+
+    for( auto& iter : io_rcPath.m_vKeys )
+    {
+      sq_release( i_pcVM, &iter.m_sqKey );
+    }
+
+    io_rcPath.m_pcVM = nullptr;
+  }
+
+
+  void ReleaseExpression( HSQUIRRELVM i_pcVM, rumDebugExpression& io_rcExpression )
+  {
+    if( io_rcExpression.m_bCompiled )
+    {
+      sq_release( i_pcVM, &io_rcExpression.m_sqClosure );
+      io_rcExpression.m_bCompiled = false;
+    }
+  }
+
+
+  SQRESULT ResolveAccessPath( HSQUIRRELVM i_pcVM, rumDebugAccessPath& io_rcPath, uint32_t i_uiStackLevel )
+  {
+    if( !io_rcPath.m_bValid )
+    {
+      return SQ_ERROR;
+    }
+
+    if( nullptr == io_rcPath.m_pcVM )
+    {
+      // Intern the root name and keys once, rather than creating a string for each on every pause
+      const auto InternKey{ [i_pcVM]( HSQOBJECT& o_rsqKey )
+      {
+        sq_getstackobj( i_pcVM, -1, &o_rsqKey );
+        sq_addref( i_pcVM, &o_rsqKey );
+        sq_poptop( i_pcVM );
+      } };
+
+      PushString( i_pcVM, io_rcPath.m_strRoot );
+      InternKey( io_rcPath.m_sqRoot );
+
+      for( auto& iter : io_rcPath.m_vKeys )
+      {
+        if( iter.m_bInteger )
+        {
+          sq_pushinteger( i_pcVM, static_cast<SQInteger>( iter.m_iKey ) );
+        }
+        else
+        {
+          PushString( i_pcVM, iter.m_strKey );
+        }
+
+        InternKey( iter.m_sqKey );
+      }
+
+      io_rcPath.m_pcVM = i_pcVM;
+    }
+    else if( io_rcPath.m_pcVM != i_pcVM )
+    {
+      // The interned objects belong to another VM
+      return SQ_ERROR;
+    }
+
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
+
+    if( !PushAccessPathRoot( i_pcVM, io_rcPath, i_uiStackLevel ) )
+    {
+      sq_settop( i_pcVM, iTop );
+      return SQ_ERROR;
+    }
+
+    for( const auto& rcKey : io_rcPath.m_vKeys )
+    {
+      sq_pushobject( i_pcVM, rcKey.m_sqKey );
+      if( SQ_FAILED( sq_get( i_pcVM, -2 ) ) )
+      {
+        sq_settop( i_pcVM, iTop );
+        return SQ_ERROR;
+      }
+
+      // Leave only the value on the stack
+      sq_remove( i_pcVM, -2 );
+    }
+
+    return SQ_OK;
+  }
+
+
+  void StartFormatBudget( uint32_t i_uiTimeBudgetMS )
+  {
+    g_tFormatDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( i_uiTimeBudgetMS );
+  }
 }
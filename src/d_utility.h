@@ -1,26 +1,93 @@
 #pragma once
 
+#include <d_accesspath.h>
+#include <d_expression.h>
+#include <d_variable.h>
+
 #include <squirrel.h>
 
 #include <string>
+#include <string_view>
 
 // Offers various convenience functions for fetching info from Squirrel and converting its data to strings for output
 
 namespace rumDebugUtility
 {
+  // Object names are looked up in an index of the root and const tables, which is rebuilt on the next lookup after the
+  // epoch advances. The VM manager advances it each time a VM pauses.
+  void AdvanceObjectNameEpoch();
+
+  // Append numbers with std::to_chars, which neither allocates nor depends on the locale. Floats are written in the
+  // shortest form that reads back as the same value, and hex integers as their unsigned 64-bit pattern.
+  void AppendFloat( SQFloat i_fValue, std::string& io_strOutput );
+  void AppendInteger( SQInteger i_iValue, bool i_bAsHex, std::string& io_strOutput );
+
+  // Format the value the same as FormatVariable and FormatVariableSummary, but append it to the output so that a
+  // caller can reuse one buffer for many values
+  void AppendVariable( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex, std::string& io_strOutput );
+  void AppendVariableSummary( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex, std::string& io_strOutput );
+
   std::string BuildInstanceDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex );
+
+  // Converts a message template such as "hp={hp}" into an expression that concatenates its text and the string
+  // values of its braced expressions. Doubled braces are treated as literal braces.
+  std::string BuildMessageExpression( const std::string& i_strTemplate );
+
   std::string BuildTableDescription( HSQUIRRELVM i_pcVM, bool i_bValuesAsHex );
 
-  // Searched the root table and stack for a matching variable name
-  SQObject FindSymbol( HSQUIRRELVM i_pcVM, const std::string& i_strVariable, uint32_t i_iLocalStackLevel );
+  // Compiles the expression against the local variables at the specified stack level
+  bool CompileExpression( HSQUIRRELVM i_pcVM, rumDebugExpression& io_rcExpression, uint32_t i_uiStackLevel );
+
+  // Fingerprints the value at the stack index for telling whether it changed since it was last formatted. Strings are
+  // hashed in full, since Squirrel's own string hash only reads the start of long strings.
+  rumDebugValueFingerprint ComputeValueFingerprint( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex );
+
+  // Evaluates the expression in the frame at the specified stack level and pushes the result on success. The expression
+  // is compiled on first use, and again only when the frame's locals differ from the ones it was compiled against.
+  SQRESULT EvaluateExpression( HSQUIRRELVM i_pcVM, rumDebugExpression& io_rcExpression, uint32_t i_uiStackLevel,
+                               uint32_t i_uiTimeBudgetMS );
 
   std::string FormatVariable( HSQUIRRELVM i_pcVM, const SQInteger i_iIndex, bool i_bValuesAsHex );
   std::string FormatVariable( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject, bool i_bValuesAsHex );
 
+  // Formats the value the same as FormatVariable, except that containers are summarized by name and size instead of
+  // having their contents described
+  std::string FormatVariableSummary( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, bool i_bValuesAsHex );
+
+  // Fetches the VM's last error as a string
+  std::string GetLastError( HSQUIRRELVM i_pcVM );
+
   std::string GetObjectName( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject );
   std::string GetTypeName( SQObjectType i_eObjectType );
 
+  // Guesses whether a line of script source holds code rather than only comments, braces, and whitespace. The block
+  // comment state carries over from the previous line.
+  bool IsExecutableLine( std::string_view i_strLine, bool& io_bInBlockComment );
+
+  bool IsIdentifier( const std::string& i_strToken );
   bool IsOperator( const std::string& i_strToken );
   bool IsReservedWord( const std::string& i_strToken );
   bool IsUnknownType( SQObjectType i_eObjectType );
+
+  // Parses a watch such as "a.b[42]["x"]" into an access path. Returns false, leaving the path invalid, if the source
+  // is not a name followed by member names and integer or string indices.
+  bool ParseAccessPath( const std::string& i_strSource, rumDebugAccessPath& o_rcPath );
+
+  // Pushes the string as the VM's character type, widening it for SQUNICODE builds. Only names and keys made of ASCII
+  // characters, such as script identifiers, are converted faithfully.
+  void PushString( HSQUIRRELVM i_pcVM, const std::string& i_strValue );
+
+  // Releases the access path's interned root name and keys, which must have been interned in the specified VM
+  void ReleaseAccessPath( HSQUIRRELVM i_pcVM, rumDebugAccessPath& io_rcPath );
+
+  void ReleaseExpression( HSQUIRRELVM i_pcVM, rumDebugExpression& io_rcExpression );
+
+  // Resolves the access path in the frame at the specified stack level and pushes the result on success. The path's
+  // root name and keys are interned in the VM the first time, and must be released with ReleaseAccessPath on the VM's
+  // thread before the path is resolved in a different VM or the VM is closed.
+  SQRESULT ResolveAccessPath( HSQUIRRELVM i_pcVM, rumDebugAccessPath& io_rcPath, uint32_t i_uiStackLevel );
+
+  // Starts a new time budget for describing containers on the calling thread. Containers reached once it runs out are
+  // summarized and marked as truncated, the same as those nested too deeply or within themselves.
+  void StartFormatBudget( uint32_t i_uiTimeBudgetMS );
 }
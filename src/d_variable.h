@@ -1,6 +1,53 @@
 #pragma once
 
-// Represents a Squirrel variable interpreted as string data for display in the Squirrel ImGui Interface
+#include <d_accesspath.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Identifies a formatted value cheaply - scalars by value, strings by hash and length, and everything else by object
+// identity plus size where it has one. Values with equal fingerprints format the same, so a value whose fingerprint
+// hasn't changed since it was last formatted can keep that formatting.
+
+struct rumDebugValueFingerprint
+{
+  bool operator==( const rumDebugValueFingerprint& i_rcFingerprint ) const
+  {
+    return( IsSameValue( i_rcFingerprint ) && m_bHex == i_rcFingerprint.m_bHex );
+  }
+
+  bool operator!=( const rumDebugValueFingerprint& i_rcFingerprint ) const
+  {
+    return !( *this == i_rcFingerprint );
+  }
+
+  // Whether both fingerprints are of the same value, regardless of how it was formatted
+  bool IsSameValue( const rumDebugValueFingerprint& i_rcFingerprint ) const
+  {
+    return( m_uiValue == i_rcFingerprint.m_uiValue && m_uiSize == i_rcFingerprint.m_uiSize &&
+            m_uiType == i_rcFingerprint.m_uiType );
+  }
+
+  bool IsSet() const
+  {
+    return m_uiType != 0;
+  }
+
+  uint64_t m_uiValue{ 0 };
+  uint32_t m_uiSize{ 0 };
+
+  // The Squirrel object type, or zero if nothing has been formatted
+  uint32_t m_uiType{ 0 };
+
+  bool m_bHex{ false };
+};
+
+
+// Represents a Squirrel variable interpreted as string data for display in the Squirrel ImGui Interface. Containers
+// are only summarized, and their children are fetched through their handle when expanded.
 
 struct rumDebugVariable
 {
@@ -8,6 +55,19 @@ struct rumDebugVariable
   std::string m_strType;
   std::string m_strValue;
 
+  // Identifies the array, table, class, or instance for fetching its children while the VM stays paused, or zero for
+  // values without children
+  uint32_t m_uiHandle{ 0 };
+
+  // The value m_strValue was formatted from
+  rumDebugValueFingerprint m_cFingerprint;
+
+  // Set when the value differs from the one it had when execution was last paused, for highlighting
+  bool m_bChanged{ false };
+
+  // The watch's name parsed as an access path, or null until the watch is first resolved
+  std::shared_ptr<rumDebugAccessPath> m_pcAccessPath;
+
   bool operator==( const rumDebugVariable& i_rcVariable ) const
   {
     return( m_strName.compare( i_rcVariable.m_strName ) == 0 );
@@ -18,3 +78,19 @@ struct rumDebugVariable
     return( m_strName.compare( i_strName ) == 0 );
   }
 };
+
+
+// The children of an expanded container, fetched from the paused VM a page at a time as they are scrolled into view
+
+struct rumDebugVariableChildren
+{
+  // Counted when the container is first expanded, without formatting any children
+  uint32_t m_uiNumChildren{ 0 };
+
+  // The iterator position each page starts from, as far as pages have been reached. Iteration resumes from the
+  // closest known position so that a later page never formats the children ahead of it.
+  std::vector<int64_t> m_vPageIterators{ 0 };
+
+  // The fetched pages keyed by page number
+  std::unordered_map<uint32_t, std::vector<rumDebugVariable>> m_mapPages;
+};
@@ -28,13 +28,19 @@ SOFTWARE.
 
 #include <d_vm.h>
 
+#include <d_export.h>
 #include <d_interface.h>
+#include <d_logbuffer.h>
 #include <d_settings.h>
 #include <d_utility.h>
 
+#include <atomic>
 #include <fstream>
+#include <memory>
 #include <regex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 #if DEBUG_OUTPUT == 0
 #define assert(x)
@@ -43,23 +49,23 @@ SOFTWARE.
 #include <sqconfig.h>
 #include <sqobject.h>
 #include <sqstring.h>
+#include <sqvm.h>
 
 #if DEBUG_OUTPUT == 0
 #undef assert
 #endif // DEBUG_OUTPUT
 
-#define SQ_LINEEXECUTION  'l'
-#define SQ_FUNCTIONCALL   'c'
-#define SQ_FUNCTIONRETURN 'r'
-
 
 namespace rumDebugVM
 {
   // Holds the mutex lock state for cross-thread communication
   std::condition_variable s_cvDebugLock;
 
-  // All of the currently attached VMs
-  std::vector<rumDebugContext> g_cDebugContexts;
+  // All of the registered VMs. A deque is used so that contexts never move once created.
+  std::deque<rumDebugContext> g_cDebugContexts;
+
+  // The registered VM contexts keyed by VM for constant-time lookup from the debug hook
+  std::unordered_map<HSQUIRRELCONSTVM, rumDebugContext*> g_mapDebugContexts;
 
   // VMs that are awaiting attach/detach state changes
   std::string g_strAttachRequest;
@@ -70,6 +76,22 @@ namespace rumDebugVM
   // Currently set breakpoints
   std::vector<rumDebugBreakpoint> g_cBreakpoints;
 
+  // Currently set function breakpoints
+  std::vector<rumDebugFunctionBreakpoint> g_cFunctionBreakpoints;
+
+  // Enabled breakpoints compiled for lookup by the debug hook. Each change to the breakpoints publishes a new
+  // immutable index rather than modifying this one, so VM threads can read it without taking a lock.
+  std::shared_ptr<const rumDebugBreakpointIndex> g_pcBreakpointIndex{ std::make_shared<rumDebugBreakpointIndex>() };
+
+  // Bumped after each index is published, invalidating anything cached from the previous breakpoint set
+  std::atomic<uint32_t> g_uiBreakpointGeneration{ 0 };
+
+  // Interned file ids keyed by generic file path
+  std::unordered_map<std::string, uint32_t> g_mapFileIDs;
+
+  // Logpoint messages awaiting display by the interface
+  rumDebugLogBuffer g_cLogBuffer;
+
   // Currently opened files
   std::map<std::string, rumDebugFile> g_cOpenedFiles;
 
@@ -85,12 +107,67 @@ namespace rumDebugVM
   // Watched variables
   std::vector<rumDebugVariable> g_cWatchVariables;
 
+  // The call the top frame's locals belong to, and their fingerprints as of this pause and the last one. Locals are
+  // only flagged as changed against the last pause while execution stays in the same call.
+  std::string g_strTopFrame;
+  std::vector<std::pair<std::string, rumDebugValueFingerprint>> g_vTopFrameLocals;
+  std::vector<std::pair<std::string, rumDebugValueFingerprint>> g_vPreviousTopFrameLocals;
+
+  // References held on the containers shown in the Locals and Watched tabs so that their children can be fetched on
+  // expansion. A handle is an index into the list plus one. The references are released when the VM resumes.
+  std::vector<HSQOBJECT> g_vVariableHandles;
+  std::unordered_map<const void*, uint32_t> g_mapVariableHandles;
+
+  // Children and full descriptions fetched for expanded variables, keyed by handle
+  std::unordered_map<uint32_t, rumDebugVariableChildren> g_mapVariableChildren;
+  std::unordered_map<uint32_t, std::string> g_mapVariableDescriptions;
+
+  // Fetches the interface is waiting on. Child counts and descriptions are keyed by handle, while pages of children
+  // are keyed by handle and page number.
+  std::vector<uint64_t> g_vRequestedChildCounts;
+  std::vector<uint64_t> g_vRequestedChildPages;
+  std::vector<uint64_t> g_vRequestedDescriptions;
+
   // The lock used when updating shared information
   std::mutex g_mtxAccessLock;
 
   // The lock used to pause execution of the main thread
   std::mutex g_mtxDebugLock;
 
+  // The lock used when interning file ids, which can happen on either thread
+  std::mutex g_mtxFileIDLock;
+
+  // The VMs being sampled, the thread that samples them, and the lock that guards both and all sample aggregates
+  std::vector<rumDebugContext*> g_vSampledContexts;
+  std::thread g_cSamplerThread;
+  std::mutex g_mtxSamplerLock;
+
+  // Sampler threads told to exit while the access lock was held. They are joined, also under the sampler lock, only
+  // once the access lock has been released.
+  std::vector<std::thread> g_vStoppedSamplerThreads;
+
+  // Wakes the sampler thread early when it should exit
+  std::condition_variable g_cvSampler;
+
+  // Bumped each time the sampler thread is told to exit, so that an exiting thread can't mistake a newly sampled VM
+  // for a reason to keep running alongside its replacement
+  uint32_t g_uiSamplerGeneration{ 0 };
+
+  std::atomic<uint32_t> g_uiSampleRateHz{ SAMPLER_DEFAULT_RATE_HZ };
+
+  // Whether time spent in the debug hook is measured
+  std::atomic<bool> g_bTimeDebugHook{ false };
+
+  // Variables formatted while building the Locals and Watched tabs, and the time spent formatting them
+  std::atomic<uint64_t> g_uiNumFormattedVariables{ 0 };
+  std::atomic<uint64_t> g_uiFormatNS{ 0 };
+
+  // Variables that kept their previous formatting because their values hadn't changed
+  std::atomic<uint64_t> g_uiNumReusedVariables{ 0 };
+
+  // The totals at the last stats reset, which are subtracted from the stats reported. Guarded by the access lock.
+  rumDebugStats g_cStatsBaseline;
+
 
   ///////////////
   // Prototypes
@@ -101,17 +178,225 @@ namespace rumDebugVM
   void AttachVM( HSQUIRRELVM i_pcVM, const std::string& i_strName );
   void DetachVM( const std::string& i_strName );
 
+  const rumDebugBreakpointIndex& AcquireBreakpointIndex( rumDebugContext& io_rcContext );
+
+  // Returns a handle to the container at the stack index, or zero if the value has no children. Must be called while
+  // holding the access lock.
+  uint32_t AcquireVariableHandle( HSQUIRRELVM i_pcVM, SQInteger i_iIndex );
+
+  // Adds a sample to the VM's sampled line counts and call tree, counting it as the specified time
+  void AggregateSample( rumDebugContext& io_rcContext, const rumDebugSample& i_rcSample, int64_t i_iWeightNS );
+
+  // Installs the debug hook on the VM if it is attached and has work for it. Like removing the hook, this is only done
+  // from Update(), on the thread the VM runs on.
+  void ArmDebugHook( rumDebugContext& io_rcContext );
+
   void BuildLocalVariables( HSQUIRRELVM i_pcVM, int32_t i_StackLevel );
-  void BuildVariables( HSQUIRRELVM i_pcVM, std::vector<rumDebugVariable>& io_vVariables );
 
+  // Summarizes the value at the stack index into the variable, acquiring a handle if it is a container. The previous
+  // formatting is kept if the value is unchanged. Returns true if the value differs from the variable's last value.
+  bool BuildVariable( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, rumDebugVariable& io_rcVariable );
+
+  // Formats one page of a container's children into its page map
+  void BuildVariableChildren( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject, uint32_t i_uiPage,
+                              rumDebugVariableChildren& io_rcChildren );
+
+  // Builds variables by name, or by access path. Variables that aren't access paths are evaluated as expressions in the
+  // selected frame when a context is given to cache their compiled closures in.
+  void BuildVariables( HSQUIRRELVM i_pcVM, std::vector<rumDebugVariable>& io_vVariables,
+                       rumDebugContext* io_pcExpressionContext );
+
+  // Records the current line and call stack for the sampler thread
+  void CaptureSample( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext, const SQChar* i_strFileName,
+                      uint32_t i_uiLine );
+
+  // Counts a call against any function breakpoints on the called function, requesting a pause if one is due
+  void CheckFunctionBreakpoints( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext,
+                                 const rumDebugBreakpointIndex& i_rcBreakpointIndex, const SQChar* i_strFunctionName );
+
+  // Totals the stats of every VM without subtracting the baseline. Must be called while holding the access lock.
+  rumDebugStats CollectStats();
+
+  int32_t CountCallDepth( HSQUIRRELVM i_pcVM );
+  uint32_t CountVariableChildren( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject );
+
+  // Returns true if the breakpoint's condition is met, which is always the case for breakpoints without a condition
+  bool EvaluateBreakpointCondition( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext, uint64_t i_uiKey,
+                                    const rumDebugBreakpoint& i_rcBreakpoint );
+
+  // Queues the access path's interned names to be released by the VM they were interned in, which happens on the VM's
+  // own thread the next time it builds its watches. Must be called while holding the access lock.
+  void EvictAccessPath( std::shared_ptr<rumDebugAccessPath>&& io_pcPath );
+
+  // Queues the watch expression's compiled closures to be released by each attached VM, which happens on the VM's own
+  // thread the next time it builds its watches. Must be called while holding the access lock.
+  void EvictWatchExpression( const std::string& i_strExpression );
+
+  rumDebugContext* FindDebugContext( HSQUIRRELCONSTVM i_pcVM );
+
+  // Builds the children and descriptions requested by the interface. Must be called while holding the access lock.
+  void FetchRequestedVariables( HSQUIRRELVM i_pcVM );
+
+  // Returns the call tree node for the function called from the parent node, adding the node if needed
+  uint32_t FindOrAddCallTreeNode( rumDebugCallTree& io_rcCallTree, std::unordered_map<uint64_t, uint32_t>& io_rmapNodes,
+                                  uint32_t i_uiParent, uint32_t i_uiFunction );
+
+  bool FunctionHasBreakpoints( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext,
+                               const rumDebugBreakpointIndex& i_rcBreakpointIndex );
+
+  uint32_t GetFileID( rumDebugContext& io_rcContext, const SQChar* i_strSource );
+  uint32_t GetProfileFunctionID( rumDebugContext& io_rcContext, const SQFunctionInfo& i_rcFunctionInfo );
   rumDebugContext* GetVMByName( const std::string& i_strName );
 
+  uint32_t InternFileID( const std::filesystem::path& i_fsFilePath );
+
+  // Waits for any stopped sampler threads to exit. Must not be called while holding the access lock.
+  void JoinStoppedSamplerThreads();
+
+  // Returns true if the called function is the breakpoint's method of its class or a class inheriting it. The method is
+  // fetched from the class into the cached object if it hasn't been already.
+  bool IsCallToClassMethod( HSQUIRRELVM i_pcVM, const rumDebugFunctionBreakpoint& i_rcBreakpoint,
+                            HSQOBJECT& io_rsqMethod );
+
+  void LogBreakpointMessage( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext, uint64_t i_uiKey,
+                             const rumDebugBreakpoint& i_rcBreakpoint, const SQChar* i_strFileName, uint32_t i_uiLine );
+
   void NativeDebugHook( HSQUIRRELVM const i_pcVM, const SQInteger i_eHookType, const SQChar* i_strFileName,
                         const SQInteger i_iLine, const SQChar* const i_strFunctionName );
 
+  // Pushes and pops the function profiler's shadow call stack, timing each call
+  void ProfileCall( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext );
+  void ProfileReturn( rumDebugContext& io_rcContext );
+
+  // Copies the call tree for display, adding the time spent so far in calls that are still executing
+  void PublishCallTree( rumDebugContext& io_rcContext );
+  void PublishSampledCallTree( rumDebugContext& io_rcContext );
+
+  // Pushes what is iterated for a container's children - the container itself, or the class of an instance
+  bool PushVariableIterable( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject );
+
+  // Asks the paused VM to fetch something for a variable handle, unless the handle is no longer valid. Must be called
+  // while holding the access lock.
+  void QueueVariableFetch( std::vector<uint64_t>& io_vRequests, uint64_t i_uiRequest, uint32_t i_uiHandle );
+
+  void RebuildBreakpointIndex();
+
+  // Releases the method closures cached for the function name's class-qualified breakpoints
+  void ReleaseClassMethods( HSQUIRRELVM i_pcVM, rumDebugContext::FunctionNameBreakpoints& io_rcFunction );
+
+  // Releases the references held for variable handles. Must be called while holding the access lock.
+  void ReleaseVariableHandles( HSQUIRRELVM i_pcVM );
+
+  void ReportBreakpointError( const rumDebugBreakpoint& i_rcBreakpoint, const std::string& i_strError );
+
+  // Requests samples from the sampled VMs at the sample rate and aggregates them, until told to exit
+  void SamplerThread( uint32_t i_uiGeneration );
+
+  // Adds the VM to the trace being recorded
+  void StartTracing( rumDebugContext& io_rcContext );
+
+  // Stops sampling the VM, aggregating any samples it has left. The sampler thread is told to exit once no VMs are
+  // sampled, and must then be joined with JoinStoppedSamplerThreads() after the access lock is released.
+  void StopSampling( rumDebugContext& io_rcContext );
+
   void SuspendVM( HSQUIRRELVM i_pcVM, rumDebugContext& i_rcContext, uint32_t i_uiLine,
                   const std::filesystem::path& i_fsFilePath );
 
+  // Services call tree resets and publishes the call tree. Must be called from the VM's thread.
+  void UpdateCallTree( rumDebugContext& io_rcContext );
+
+  bool WantsDebugHook( const rumDebugContext& i_rcContext );
+
+
+  const rumDebugBreakpointIndex& AcquireBreakpointIndex( rumDebugContext& io_rcContext )
+  {
+    // The generation is bumped after the index is stored, so a changed generation guarantees at least that index
+    const uint32_t uiGeneration{ g_uiBreakpointGeneration.load( std::memory_order_acquire ) };
+    if( !io_rcContext.m_pcBreakpointIndex || io_rcContext.m_uiBreakpointGeneration != uiGeneration )
+    {
+      io_rcContext.m_pcBreakpointIndex = std::atomic_load_explicit( &g_pcBreakpointIndex, std::memory_order_acquire );
+      io_rcContext.m_uiBreakpointGeneration = uiGeneration;
+    }
+
+    return *io_rcContext.m_pcBreakpointIndex;
+  }
+
+
+  uint32_t AcquireVariableHandle( HSQUIRRELVM i_pcVM, SQInteger i_iIndex )
+  {
+    HSQOBJECT sqObject;
+    sq_getstackobj( i_pcVM, i_iIndex, &sqObject );
+
+    switch( sq_type( sqObject ) )
+    {
+      case OT_ARRAY:
+      case OT_TABLE:
+      case OT_CLASS:
+      case OT_INSTANCE:
+        break;
+
+      default:
+        return 0;
+    }
+
+    // The same container reached through several variables shares a handle
+    const auto& iter{ g_mapVariableHandles.find( sqObject._unVal.pRefCounted ) };
+    if( iter != g_mapVariableHandles.end() )
+    {
+      return iter->second;
+    }
+
+    sq_addref( i_pcVM, &sqObject );
+    g_vVariableHandles.push_back( sqObject );
+
+    const uint32_t uiHandle{ static_cast<uint32_t>( g_vVariableHandles.size() ) };
+    g_mapVariableHandles.emplace( sqObject._unVal.pRefCounted, uiHandle );
+
+    return uiHandle;
+  }
+
+
+  void AggregateSample( rumDebugContext& io_rcContext, const rumDebugSample& i_rcSample, int64_t i_iWeightNS )
+  {
+    io_rcContext.m_cSampledLineCounts.Increment( i_rcSample.m_uiFileID, i_rcSample.m_uiLine );
+
+    auto& rcCallTree{ io_rcContext.m_cSampledCallTree };
+
+    // Walk the call tree from the outermost frame in, counting the sample against every call on the stack
+    uint32_t uiNode{ 0 };
+    for( uint32_t uiFrame{ i_rcSample.m_uiNumFrames }; uiFrame-- > 0; )
+    {
+      uiNode = FindOrAddCallTreeNode( rcCallTree, io_rcContext.m_mapSampledCallTreeNodes, uiNode,
+                                      i_rcSample.m_uiFunctions[uiFrame] );
+      rcCallTree.m_vNodes[uiNode].m_iInclusiveNS += i_iWeightNS;
+    }
+
+    if( uiNode != 0 )
+    {
+      // The innermost call was the one executing
+      auto& rcNode{ rcCallTree.m_vNodes[uiNode] };
+      rcNode.m_iExclusiveNS += i_iWeightNS;
+      ++rcNode.m_uiNumCalls;
+    }
+
+    io_rcContext.m_bSampledCallTreeChanged = true;
+  }
+
+
+  void ArmDebugHook( rumDebugContext& io_rcContext )
+  {
+    if( !io_rcContext.m_bHookInstalled && WantsDebugHook( io_rcContext ) )
+    {
+      // Calls and returns weren't tracked while the hook was removed, so neither the call depth nor the cached answer
+      // for the executing function can be trusted
+      io_rcContext.m_bResyncCallDepth = true;
+      io_rcContext.m_bFunctionBreakpointsValid = false;
+      io_rcContext.m_bHookInstalled = true;
+
+      sq_setnativedebughook( io_rcContext.m_pcVM, &NativeDebugHook );
+    }
+  }
+
 
   void AttachVM( const std::string& i_strName )
   {
@@ -127,8 +412,8 @@ namespace rumDebugVM
     std::string strName;
 
     // Is this vm already registered?
-    const auto& iter{ std::find( g_cDebugContexts.begin(), g_cDebugContexts.end(), i_pcVM ) };
-    if( iter == g_cDebugContexts.end() )
+    const rumDebugContext* pcContext{ FindDebugContext( i_pcVM ) };
+    if( nullptr == pcContext )
     {
       // Create a name
       std::ostringstream strAddress;
@@ -138,7 +423,7 @@ namespace rumDebugVM
     else
     {
       // Use the existing name
-      strName = iter->m_strName;
+      strName = pcContext->m_strName;
     }
 
     AttachVM( i_pcVM, strName );
@@ -149,34 +434,36 @@ namespace rumDebugVM
 
   void AttachVM( HSQUIRRELVM i_pcVM, const std::string& i_strName )
   {
-    const auto& iter{ std::find( g_cDebugContexts.begin(), g_cDebugContexts.end(), i_pcVM ) };
-    if( iter == g_cDebugContexts.end() )
+    rumDebugContext* pcContext{ FindDebugContext( i_pcVM ) };
+    if( nullptr == pcContext )
     {
       // Create a new context and attach to it
-      rumDebugContext cContext( i_pcVM );
-      cContext.m_strName = i_strName;
-      cContext.m_bAttached = true;
-
-      if( nullptr == g_pcCurrentDebugContext )
-      {
-        g_pcCurrentDebugContext = &cContext;
-      }
+      pcContext = &g_cDebugContexts.emplace_back( i_pcVM );
+      pcContext->m_strName = i_strName;
+      pcContext->m_bAttached = true;
 
-      g_cDebugContexts.emplace_back( std::move( cContext ) );
+      g_mapDebugContexts.insert( std::make_pair( i_pcVM, pcContext ) );
     }
     else
     {
       // Attach to the existing context
-      iter->m_bAttached = true;
+      pcContext->m_bAttached = true;
 
-      if( nullptr == g_pcCurrentDebugContext )
-      {
-        g_pcCurrentDebugContext = &*iter;
-      }
+      // Calls and returns weren't tracked while detached
+      pcContext->m_bResyncCallDepth = true;
+      pcContext->m_bFunctionBreakpointsValid = false;
     }
 
-    sq_setnativedebughook( i_pcVM, &NativeDebugHook );
+    if( nullptr == g_pcCurrentDebugContext )
+    {
+      g_pcCurrentDebugContext = pcContext;
+    }
 
+    if( !pcContext->m_bTracing && rumDebugExport::IsTracing() )
+    {
+      // VMs attached during a trace join it
+      StartTracing( *pcContext );
+    }
   }
 
 
@@ -185,6 +472,7 @@ namespace rumDebugVM
     std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
 
     g_cBreakpoints.emplace_back( std::move( i_cBreakpoint ) );
+    RebuildBreakpointIndex();
 
     rumDebugInterface::RequestSettingsUpdate();
   }
@@ -199,6 +487,46 @@ namespace rumDebugVM
     {
       // Remove the existing breakpoint
       g_cBreakpoints.erase( iter );
+      RebuildBreakpointIndex();
+
+      // The hook is removed on the next Update() if nothing else needs it
+
+      rumDebugInterface::RequestSettingsUpdate();
+    }
+  }
+
+
+  void BreakpointSetCondition( const rumDebugBreakpoint& i_rcBreakpoint, const std::string& i_strCondition )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cBreakpoints.begin(), g_cBreakpoints.end(), i_rcBreakpoint ) };
+    if( iter != g_cBreakpoints.end() )
+    {
+      iter->m_strCondition = i_strCondition;
+      iter->m_strError.clear();
+
+      // Each VM compiles the new condition the next time the breakpoint's line is reached
+      RebuildBreakpointIndex();
+
+      rumDebugInterface::RequestSettingsUpdate();
+    }
+  }
+
+
+  void BreakpointSetLogMessage( const rumDebugBreakpoint& i_rcBreakpoint, const std::string& i_strLogMessage )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cBreakpoints.begin(), g_cBreakpoints.end(), i_rcBreakpoint ) };
+    if( iter != g_cBreakpoints.end() )
+    {
+      iter->m_strLogMessage = i_strLogMessage;
+      iter->m_strError.clear();
+
+      // Each VM compiles the new message the next time the breakpoint's line is reached
+      RebuildBreakpointIndex();
+
       rumDebugInterface::RequestSettingsUpdate();
     }
   }
@@ -220,6 +548,8 @@ namespace rumDebugVM
       iter->m_bEnabled = !iter->m_bEnabled;
     }
 
+    RebuildBreakpointIndex();
+
     rumDebugInterface::RequestSettingsUpdate();
   }
 
@@ -230,26 +560,58 @@ namespace rumDebugVM
     SQInteger iTopBegin{ sq_gettop( i_pcVM ) };
 #endif
 
-    g_cLocalVariables.clear();
+    const rumDebugScopeTimer cFormatTimer( g_uiFormatNS );
+
+    // Entries from the last build are overwritten in place so that their strings' storage is reused
+    size_t szNumLocals{ 0 };
 
     int32_t iIndex{ 0 };
     const SQChar* strName{ sq_getlocal( i_pcVM, i_StackLevel, iIndex++ ) };
     while( strName )
     {
-      const SQObjectType eType{ sq_gettype( i_pcVM, -1 ) };
+      if( szNumLocals == g_cLocalVariables.size() )
+      {
+        g_cLocalVariables.emplace_back();
+      }
+
+      const size_t szLocal{ szNumLocals++ };
+
+      rumDebugVariable& rcLocalEntry{ g_cLocalVariables[szLocal] };
+      rcLocalEntry.m_strName = strName;
+      BuildVariable( i_pcVM, -1, rcLocalEntry );
+
+      // Only the top frame is compared against the last pause
+      rcLocalEntry.m_bChanged = false;
+      if( 0 == i_StackLevel )
+      {
+        if( szLocal < g_vPreviousTopFrameLocals.size() )
+        {
+          const auto& rcPrevious{ g_vPreviousTopFrameLocals[szLocal] };
+          rcLocalEntry.m_bChanged = rcPrevious.first.compare( strName ) == 0 &&
+                                    !rcPrevious.second.IsSameValue( rcLocalEntry.m_cFingerprint );
+        }
 
-      rumDebugVariable cLocalEntry;
-      cLocalEntry.m_strName = strName;
-      cLocalEntry.m_strType = rumDebugUtility::GetTypeName( eType );
-      cLocalEntry.m_strValue = rumDebugUtility::FormatVariable( i_pcVM, -1, rumDebugInterface::WantsValuesAsHex() );
+        if( szLocal == g_vTopFrameLocals.size() )
+        {
+          g_vTopFrameLocals.emplace_back();
+        }
 
-      g_cLocalVariables.emplace_back( std::move( cLocalEntry ) );
+        g_vTopFrameLocals[szLocal].first = strName;
+        g_vTopFrameLocals[szLocal].second = rcLocalEntry.m_cFingerprint;
+      }
 
       sq_poptop( i_pcVM );
 
       strName = sq_getlocal( i_pcVM, i_StackLevel, iIndex++ );
     }
 
+    g_cLocalVariables.resize( szNumLocals );
+
+    if( 0 == i_StackLevel )
+    {
+      g_vTopFrameLocals.resize( szNumLocals );
+    }
+
 #if DEBUG_OUTPUT
     SQInteger iTopEnd{ sq_gettop( i_pcVM ) };
     assert( iTopBegin == iTopEnd );
@@ -257,366 +619,1954 @@ namespace rumDebugVM
   }
 
 
-  void BuildVariables( HSQUIRRELVM i_pcVM, std::vector<rumDebugVariable>& io_vVariables )
+  bool BuildVariable( HSQUIRRELVM i_pcVM, SQInteger i_iIndex, rumDebugVariable& io_rcVariable )
   {
-    for( auto& watchIter : io_vVariables )
-    {
-      // Check locals first
-      const auto& localIter{ std::find( g_cLocalVariables.begin(), g_cLocalVariables.end(), watchIter ) };
-      if( localIter != g_cLocalVariables.end() )
-      {
-        // This watch variable is a local variable, so just re-use that info
-        watchIter.m_strType = localIter->m_strType;
-        watchIter.m_strValue = localIter->m_strValue;
-      }
-      else
-      {
-        SQObject sqObject{ rumDebugUtility::FindSymbol( i_pcVM, watchIter.m_strName, g_uiLocalVariableStackLevel ) };
-        if( rumDebugUtility::IsUnknownType( sqObject._type ) )
-        {
-          // Try one more time with a "this." prefix
-          std::string strVariable( "this." + watchIter.m_strName );
-          sqObject = rumDebugUtility::FindSymbol( i_pcVM, strVariable, g_uiLocalVariableStackLevel );
-        }
-
-        watchIter.m_strType = rumDebugUtility::GetTypeName( sqObject._type );
-        watchIter.m_strValue = rumDebugUtility::FormatVariable( i_pcVM, sqObject, rumDebugInterface::WantsValuesAsHex() );
-      }
-    }
-  }
-
+    // Handles only last for one pause, so they are always acquired
+    io_rcVariable.m_uiHandle = AcquireVariableHandle( i_pcVM, i_iIndex );
 
-  SQInteger DetachVM( HSQUIRRELVM i_pcVM )
-  {
-    const auto& iter{ std::find( g_cDebugContexts.begin(), g_cDebugContexts.end(), i_pcVM ) };
-    if( iter != g_cDebugContexts.end() )
+    const rumDebugValueFingerprint cFingerprint{
+      rumDebugUtility::ComputeValueFingerprint( i_pcVM, i_iIndex, rumDebugInterface::WantsValuesAsHex() ) };
+    if( cFingerprint == io_rcVariable.m_cFingerprint )
     {
-      bool bPaused{ iter->m_bPaused };
+      g_uiNumReusedVariables.fetch_add( 1, std::memory_order_relaxed );
+      return false;
+    }
 
-      iter->m_eStepDirective = rumDebugContext::StepDirective::Resume;
-      iter->m_bAttached = false;
+    const bool bChanged{ io_rcVariable.m_cFingerprint.IsSet() &&
+                         !io_rcVariable.m_cFingerprint.IsSameValue( cFingerprint ) };
 
-      sq_setnativedebughook( i_pcVM, NULL );
+    io_rcVariable.m_strType = rumDebugUtility::GetTypeName( sq_gettype( i_pcVM, i_iIndex ) );
 
-      if( bPaused )
-      {
-        RequestResume();
-      }
+    io_rcVariable.m_strValue.clear();
+    rumDebugUtility::AppendVariableSummary( i_pcVM, i_iIndex, cFingerprint.m_bHex, io_rcVariable.m_strValue );
+    io_rcVariable.m_cFingerprint = cFingerprint;
 
-      return SQ_OK;
-    }
+    g_uiNumFormattedVariables.fetch_add( 1, std::memory_order_relaxed );
 
-    return SQ_ERROR;
+    return bChanged;
   }
 
 
-  void DetachVM( const std::string& i_strName )
+  void BuildVariableChildren( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject, uint32_t i_uiPage,
+                              rumDebugVariableChildren& io_rcChildren )
   {
-    rumDebugContext* pcVM{ GetVMByName( i_strName ) };
-    if( pcVM )
+    const rumDebugScopeTimer cFormatTimer( g_uiFormatNS );
+
+    std::vector<rumDebugVariable>& rcvPage{ io_rcChildren.m_mapPages[i_uiPage] };
+
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
+    const bool bInstance{ sq_type( i_sqObject ) == OT_INSTANCE };
+
+    if( !PushVariableIterable( i_pcVM, i_sqObject ) )
     {
-      DetachVM( pcVM->m_pcVM );
+      return;
     }
-  }
 
+    // An array's iterator is the element index, so any page can be started directly. Otherwise, iteration resumes
+    // from the closest page whose starting position is known, skipping the children in between without formatting.
+    SQInteger iIterator{ static_cast<SQInteger>( i_uiPage ) * VARIABLE_PAGE_SIZE };
+    if( sq_type( i_sqObject ) != OT_ARRAY )
+    {
+      auto& rcvPageIterators{ io_rcChildren.m_vPageIterators };
+      while( rcvPageIterators.size() <= i_uiPage )
+      {
+        sq_pushinteger( i_pcVM, static_cast<SQInteger>( rcvPageIterators.back() ) );
 
-  void EnableDebugInfo( HSQUIRRELVM i_pcVM, bool i_bEnable )
-  {
-    sq_enabledebuginfo( i_pcVM, i_bEnable ? SQTrue : SQFalse );
-  }
+        uint32_t uiNumSkipped{ 0 };
+        while( uiNumSkipped < VARIABLE_PAGE_SIZE && SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) ) )
+        {
+          sq_pop( i_pcVM, 2 );
+          ++uiNumSkipped;
+        }
 
+        sq_getinteger( i_pcVM, -1, &iIterator );
+        sq_poptop( i_pcVM );
 
-  void FileClose( const std::filesystem::path& i_fsFilePath )
-  {
-    std::string strFilePath{ i_fsFilePath.generic_string() };
+        if( uiNumSkipped < VARIABLE_PAGE_SIZE )
+        {
+          // The page is past the last child
+          sq_settop( i_pcVM, iTop );
+          return;
+        }
 
-    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+        rcvPageIterators.push_back( iIterator );
+      }
 
-    const auto& iter{ g_cOpenedFiles.find( strFilePath ) };
-    if( iter != g_cOpenedFiles.end() )
-    {
-      g_cOpenedFiles.erase( iter );
+      iIterator = static_cast<SQInteger>( rcvPageIterators[i_uiPage] );
     }
 
-    rumDebugInterface::RequestSettingsUpdate();
-  }
+    sq_pushinteger( i_pcVM, iIterator );
+    const SQInteger iIterTop{ sq_gettop( i_pcVM ) };
 
+    while( rcvPage.size() < VARIABLE_PAGE_SIZE && SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) ) )
+    {
+      rumDebugVariable cChild;
 
-  void FileOpen( const std::filesystem::path& i_fsFilePath, uint32_t i_uiLine )
-  {
-    std::string strFilePath{ i_fsFilePath.generic_string() };
+      const SQObjectType eKeyType{ sq_gettype( i_pcVM, -2 ) };
+      if( OT_STRING == eKeyType )
+      {
+        const SQChar* strKey{ nullptr };
+        sq_getstring( i_pcVM, -2, &strKey );
+        cChild.m_strName = strKey;
+      }
+      else
+      {
+        cChild.m_strName = '[';
+        rumDebugUtility::AppendVariable( i_pcVM, -2, false, cChild.m_strName );
+        cChild.m_strName += ']';
+      }
 
-    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+      if( bInstance )
+      {
+        // Replace the class's default value with the instance's value
+        sq_poptop( i_pcVM );
+        sq_pushobject( i_pcVM, i_sqObject );
+        sq_push( i_pcVM, -2 );
+        if( SQ_FAILED( sq_get( i_pcVM, -2 ) ) )
+        {
+          sq_pushnull( i_pcVM );
+        }
+      }
 
-    // Determine if the file is already opened
-    const auto& iter{ g_cOpenedFiles.find( strFilePath ) };
-    if( iter == g_cOpenedFiles.end() )
-    {
-      // Open and cache the file contents
-      rumDebugFile cFile;
-      cFile.m_fsFilePath = i_fsFilePath;
-      cFile.m_strFilename = i_fsFilePath.filename().generic_string();
+      BuildVariable( i_pcVM, -1, cChild );
+      rcvPage.emplace_back( std::move( cChild ) );
 
-      std::ifstream cInfile;
-      cInfile.open( cFile.m_fsFilePath.native().c_str() );
+      // Pop everything but the iterator
+      sq_settop( i_pcVM, iIterTop );
+    }
 
-      std::ostringstream cBuffer;
-      cBuffer << cInfile.rdbuf();
-      cFile.m_strData = cBuffer.str();
+    sq_settop( i_pcVM, iTop );
+  }
 
-      cFile.m_vStringOffsets.resize( 10000 );
 
-      size_t szLastOffset{ 0 };
-      size_t szCurrentOffset{ 0 };
-      size_t uiLongestLine{ rumDebugFile::s_uiMinimumColumns };
+  void BuildVariables( HSQUIRRELVM i_pcVM, std::vector<rumDebugVariable>& io_vVariables,
+                       rumDebugContext* io_pcExpressionContext )
+  {
+    const rumDebugScopeTimer cFormatTimer( g_uiFormatNS );
 
-      bool bInMultilineComment{ false };
-      uint32_t iMultilineCommentStart{ 0 };
+    if( io_pcExpressionContext )
+    {
+      // Release the closures of expressions that were edited or removed, so that one typed again starts over
+      for( const auto& iter : io_pcExpressionContext->m_vEvictedWatchExpressions )
+      {
+        const auto& expressionIter{ io_pcExpressionContext->m_mapWatchExpressions.find( iter ) };
+        if( expressionIter != io_pcExpressionContext->m_mapWatchExpressions.end() )
+        {
+          rumDebugUtility::ReleaseExpression( i_pcVM, expressionIter->second );
+          io_pcExpressionContext->m_mapWatchExpressions.erase( expressionIter );
+        }
+      }
 
-      uint32_t index{ 0 };
+      io_pcExpressionContext->m_vEvictedWatchExpressions.clear();
 
-      while( ( szCurrentOffset = cFile.m_strData.find( '\n', szLastOffset ) ) != std::string::npos )
+      for( auto& iter : io_pcExpressionContext->m_vEvictedAccessPaths )
       {
-        cFile.m_vStringOffsets[++index] = ++szCurrentOffset;
+        rumDebugUtility::ReleaseAccessPath( i_pcVM, *iter );
+      }
 
-        std::string_view strLine{ std::string_view( cFile.m_strData ).substr( szLastOffset, szCurrentOffset - szLastOffset ) };
-        const size_t uiLineLength{ strLine.size() };
-        uiLongestLine = { std::max( uiLineLength, uiLongestLine ) };
+      io_pcExpressionContext->m_vEvictedAccessPaths.clear();
+    }
 
-        // Parse multiline comment ranges
-        size_t iMultilineCommentStartSymbol{ strLine.find( "/*" ) };
-        if( !bInMultilineComment && iMultilineCommentStartSymbol != std::string::npos )
+    for( auto& watchIter : io_vVariables )
+    {
+      // Check locals first
+      const auto& localIter{ std::find( g_cLocalVariables.begin(), g_cLocalVariables.end(), watchIter ) };
+      if( localIter != g_cLocalVariables.end() )
+      {
+        // This watch variable is a local variable, so just re-use that info
+        if( watchIter.m_cFingerprint.IsSet() && !watchIter.m_cFingerprint.IsSameValue( localIter->m_cFingerprint ) )
         {
-          size_t iMultilineCommentEndSymbol{ strLine.find( "*/" ) };
-          while( iMultilineCommentStartSymbol != std::string::npos && iMultilineCommentEndSymbol != std::string::npos )
+          watchIter.m_bChanged = true;
+        }
+
+        if( watchIter.m_cFingerprint != localIter->m_cFingerprint )
+        {
+          watchIter.m_strType = localIter->m_strType;
+          watchIter.m_strValue = localIter->m_strValue;
+          watchIter.m_cFingerprint = localIter->m_cFingerprint;
+        }
+
+        watchIter.m_uiHandle = localIter->m_uiHandle;
+      }
+      else
+      {
+        if( watchIter.m_pcAccessPath && watchIter.m_pcAccessPath->m_pcVM &&
+            watchIter.m_pcAccessPath->m_pcVM != i_pcVM )
+        {
+          // The path's names are interned in another VM, which releases them, so it's parsed again for this one
+          EvictAccessPath( std::move( watchIter.m_pcAccessPath ) );
+          watchIter.m_pcAccessPath.reset();
+        }
+
+        // The watch is parsed once, and only resolved on later pauses
+        if( !watchIter.m_pcAccessPath )
+        {
+          watchIter.m_pcAccessPath = std::make_shared<rumDebugAccessPath>();
+          rumDebugUtility::ParseAccessPath( watchIter.m_strName, *watchIter.m_pcAccessPath );
+        }
+
+        if( !watchIter.m_pcAccessPath->m_bValid && io_pcExpressionContext )
+        {
+          // Anything else is an expression, compiled once per VM and then only re-run
+          auto& rcExpression{ io_pcExpressionContext->m_mapWatchExpressions[watchIter.m_strName] };
+          if( rcExpression.m_strExpression.empty() )
           {
-            while( iMultilineCommentEndSymbol != std::string::npos && iMultilineCommentEndSymbol < iMultilineCommentStartSymbol )
-            {
-              // end before start, let's check if we have real closure in this line
-              iMultilineCommentEndSymbol = strLine.find( "*/", iMultilineCommentEndSymbol + 2 );
-            }
-            if( iMultilineCommentEndSymbol != std::string::npos )
-            {
-              // found a closure for multiline comment in same line, let's check that if we try to start a new multi line comment after this block
-              iMultilineCommentStartSymbol = strLine.find( "/*", iMultilineCommentEndSymbol + 2 );
-            }
+            rcExpression.m_strExpression = watchIter.m_strName;
           }
-          if( iMultilineCommentStartSymbol != std::string::npos )
+
+          if( SQ_FAILED( rumDebugUtility::EvaluateExpression( i_pcVM, rcExpression, g_uiLocalVariableStackLevel,
+                                                              WATCH_TIME_BUDGET_MS ) ) )
           {
-            bInMultilineComment = true;
-            iMultilineCommentStart = index;
+            // Show the error in place of the value until the expression succeeds
+            watchIter.m_strType = "error";
+            watchIter.m_strValue = rcExpression.m_strError;
+            watchIter.m_uiHandle = 0;
+            watchIter.m_cFingerprint = rumDebugValueFingerprint();
+            continue;
           }
         }
-        else if( bInMultilineComment && strLine.find( "*/" ) != std::string::npos )
+        else if( SQ_FAILED( rumDebugUtility::ResolveAccessPath( i_pcVM, *watchIter.m_pcAccessPath,
+                                                                g_uiLocalVariableStackLevel ) ) )
         {
-          rumDebugFile::MultilineComment cMultilineComment;
-          cMultilineComment.m_iStartLine = iMultilineCommentStart;
-          cMultilineComment.m_iEndLine = index;
-
-          cFile.m_vMultilineComments.emplace_back( std::move( cMultilineComment ) );
+          // Distinguish a missing name or key from a value that is null
+          watchIter.m_strType.clear();
+          watchIter.m_strValue = "<not found>";
+          watchIter.m_uiHandle = 0;
+          watchIter.m_cFingerprint = rumDebugValueFingerprint();
+          continue;
+        }
 
-          bInMultilineComment = false;
+        if( BuildVariable( i_pcVM, -1, watchIter ) )
+        {
+          watchIter.m_bChanged = true;
         }
+        sq_poptop( i_pcVM );
+      }
+    }
+  }
 
-        szLastOffset = szCurrentOffset;
+
+  void CaptureSample( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext, const SQChar* i_strFileName,
+                      uint32_t i_uiLine )
+  {
+    io_rcContext.m_bSampleRequested.store( false, std::memory_order_relaxed );
+
+    rumDebugSampleBuffer* pcSampleBuffer{ io_rcContext.m_pcSampleBuffer.get() };
+    rumDebugSample* pcSample{ pcSampleBuffer ? pcSampleBuffer->BeginPush() : nullptr };
+    if( nullptr == pcSample )
+    {
+      // The sampler thread hasn't caught up, so this sample is dropped
+      return;
+    }
+
+    pcSample->m_uiFileID = GetFileID( io_rcContext, i_strFileName );
+    pcSample->m_uiLine = i_uiLine;
+    pcSample->m_uiNumFrames = 0;
+
+    SQStackInfos cStackInfos;
+    for( SQInteger iLevel{ 0 }; pcSample->m_uiNumFrames < SAMPLER_MAX_FRAMES &&
+                                SQ_SUCCEEDED( sq_stackinfos( i_pcVM, iLevel, &cStackInfos ) ); ++iLevel )
+    {
+      // Native functions have no function info and are left out
+      SQFunctionInfo cFunctionInfo;
+      if( SQ_SUCCEEDED( sq_getfunctioninfo( i_pcVM, iLevel, &cFunctionInfo ) ) )
+      {
+        pcSample->m_uiFunctions[pcSample->m_uiNumFrames++] = GetProfileFunctionID( io_rcContext, cFunctionInfo );
       }
+    }
 
-      // Add the last offset if there isn't a final '\n'
-      if( szLastOffset != cFile.m_strData.length() )
+    if( io_rcContext.m_bTracing && pcSample->m_uiNumFrames > 0 )
+    {
+      io_rcContext.m_pcTraceBuffer->Push( { rumDebugTraceEvent::ToTimeNS( std::chrono::steady_clock::now() ), 0,
+                                            pcSample->m_uiFunctions[0], i_uiLine, 0,
+                                            rumDebugTraceEvent::Type::Sample } );
+    }
+
+    pcSampleBuffer->EndPush();
+  }
+
+
+  void CheckFunctionBreakpoints( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext,
+                                 const rumDebugBreakpointIndex& i_rcBreakpointIndex, const SQChar* i_strFunctionName )
+  {
+    const uint32_t uiGeneration{ io_rcContext.m_uiBreakpointGeneration };
+
+    auto& rcFunction{ io_rcContext.m_mapFunctionNameBreakpoints[i_strFunctionName] };
+    if( !rcFunction.m_bResolved || rcFunction.m_uiGeneration != uiGeneration ||
+        rcFunction.m_strName.compare( i_strFunctionName ) != 0 )
+    {
+      // First call to this name since the breakpoints changed, or its pointer has been reused for a different name
+      ReleaseClassMethods( i_pcVM, rcFunction );
+
+      rcFunction.m_strName = i_strFunctionName;
+      rcFunction.m_pcvBreakpoints = i_rcBreakpointIndex.FindFunctionBreakpoints( i_strFunctionName );
+      rcFunction.m_uiGeneration = uiGeneration;
+      rcFunction.m_bResolved = true;
+
+      if( rcFunction.m_pcvBreakpoints )
       {
-        cFile.m_vStringOffsets[index++] = cFile.m_strData.length();
+        HSQOBJECT sqNull;
+        sq_resetobject( &sqNull );
+        rcFunction.m_vMethods.assign( rcFunction.m_pcvBreakpoints->size(), sqNull );
       }
+    }
 
-      // Handle files that do not have a closing multiline comment
-      if( bInMultilineComment )
+    if( nullptr == rcFunction.m_pcvBreakpoints )
+    {
+      return;
+    }
+
+    for( size_t i{ 0 }; i < rcFunction.m_pcvBreakpoints->size(); ++i )
+    {
+      const rumDebugFunctionBreakpoint& iter{ ( *rcFunction.m_pcvBreakpoints )[i] };
+      if( !iter.m_strClass.empty() && !IsCallToClassMethod( i_pcVM, iter, rcFunction.m_vMethods[i] ) )
       {
-        rumDebugFile::MultilineComment cMultilineComment;
-        cMultilineComment.m_iStartLine = iMultilineCommentStart;
-        cMultilineComment.m_iEndLine = index;
+        continue;
+      }
 
-        cFile.m_vMultilineComments.emplace_back( std::move( cMultilineComment ) );
+      const uint32_t uiNumHits{ iter.m_pcNumHits->fetch_add( 1, std::memory_order_relaxed ) + 1 };
+      if( 0 == iter.m_uiHitCount || uiNumHits == iter.m_uiHitCount )
+      {
+        // Pause on the first line executed in the called function
+        io_rcContext.m_bPauseRequested = true;
       }
+    }
+  }
 
-      cFile.m_vStringOffsets.resize( index + 1 );
-      cFile.m_uiLongestLine = uiLongestLine;
 
-      g_cOpenedFiles.insert( std::make_pair( strFilePath, std::move( cFile ) ) );
-      rumDebugInterface::RequestSettingsUpdate();
+  rumDebugStats CollectStats()
+  {
+    rumDebugStats cStats;
+
+    for( const auto& iter : g_cDebugContexts )
+    {
+      const rumDebugHookStats& rcHookStats{ iter.m_cHookStats };
+      cStats.m_uiNumCallEvents += rcHookStats.m_uiNumCallEvents.load( std::memory_order_relaxed );
+      cStats.m_uiNumReturnEvents += rcHookStats.m_uiNumReturnEvents.load( std::memory_order_relaxed );
+      cStats.m_uiNumLineEvents += rcHookStats.m_uiNumLineEvents.load( std::memory_order_relaxed );
+      cStats.m_uiHookNS += rcHookStats.m_uiHookNS.load( std::memory_order_relaxed );
+      cStats.m_uiNumBreakpointChecks += rcHookStats.m_uiNumBreakpointChecks.load( std::memory_order_relaxed );
+      cStats.m_uiNumPauses += rcHookStats.m_uiNumPauses.load( std::memory_order_relaxed );
+      cStats.m_uiPausedNS += rcHookStats.m_uiPausedNS.load( std::memory_order_relaxed );
     }
 
-    // Request a switch to the target file and line
-    rumDebugInterface::SetFileFocus( i_fsFilePath, i_uiLine );
-  }
+    cStats.m_uiNumFormattedVariables = g_uiNumFormattedVariables.load( std::memory_order_relaxed );
+    cStats.m_uiNumReusedVariables = g_uiNumReusedVariables.load( std::memory_order_relaxed );
+    cStats.m_uiFormatNS = g_uiFormatNS.load( std::memory_order_relaxed );
 
+    for( const auto& iter : g_cOpenedFiles )
+    {
+      const rumDebugFile& rcFile{ iter.second };
+      cStats.m_uiCachedFileBytes += rcFile.m_strData.capacity() +
+                                    rcFile.m_vStringOffsets.capacity() * sizeof( rcFile.m_vStringOffsets[0] ) +
+                                    rcFile.m_vMultilineComments.capacity() * sizeof( rcFile.m_vMultilineComments[0] );
+    }
 
-  const std::vector<rumDebugBreakpoint> GetBreakpointsCopy()
-  {
-    return g_cBreakpoints;
+    cStats.m_uiNumCachedFiles = g_cOpenedFiles.size();
+
+    return cStats;
   }
 
 
-  const std::vector<rumDebugBreakpoint>& GetBreakpointsRef()
+  int32_t CountCallDepth( HSQUIRRELVM i_pcVM )
   {
-    return g_cBreakpoints;
-  }
+    // Only script frames raise call and return events, so native frames are not counted
+    int32_t iCallDepth{ 0 };
 
+    SQStackInfos cStackInfos;
+    SQInteger iStackLevel{ 0 };
+    while( SQ_SUCCEEDED( sq_stackinfos( i_pcVM, iStackLevel++, &cStackInfos ) ) )
+    {
+      if( cStackInfos.line >= 0 )
+      {
+        ++iCallDepth;
+      }
+    }
 
-  const rumDebugContext* GetCurrentDebugContext()
-  {
-    return g_pcCurrentDebugContext;
+    return iCallDepth;
   }
 
 
-  const std::vector<rumDebugContext>& GetDebugContexts()
+  uint32_t CountVariableChildren( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject )
   {
-    return g_cDebugContexts;
-  }
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
 
+    if( !PushVariableIterable( i_pcVM, i_sqObject ) )
+    {
+      return 0;
+    }
 
-  const std::vector<rumDebugVariable>& GetLocalVariablesRef()
-  {
-    return g_cLocalVariables;
+    SQInteger iNumChildren{ 0 };
+
+    const SQObjectType eType{ sq_gettype( i_pcVM, -1 ) };
+    if( OT_ARRAY == eType || OT_TABLE == eType )
+    {
+      iNumChildren = sq_getsize( i_pcVM, -1 );
+    }
+    else
+    {
+      // The size of a class is its user data size, so its members have to be walked
+      sq_pushnull( i_pcVM );
+      while( SQ_SUCCEEDED( sq_next( i_pcVM, -2 ) ) )
+      {
+        sq_pop( i_pcVM, 2 );
+        ++iNumChildren;
+      }
+    }
+
+    sq_settop( i_pcVM, iTop );
+
+    return static_cast<uint32_t>( std::max<SQInteger>( iNumChildren, 0 ) );
   }
 
 
-  const std::map<std::string, rumDebugFile> GetOpenedFilesCopy()
+  void CoverageReset( const std::string& i_strName )
   {
-    return g_cOpenedFiles;
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      pcContext->m_cLineCoverage.Reset();
+    }
   }
 
 
-  const std::map<std::string, rumDebugFile>& GetOpenedFilesRef()
+  void CoverageStart( const std::string& i_strName )
   {
-    return g_cOpenedFiles;
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext && pcContext->m_bAttached )
+    {
+      pcContext->m_bLineCoverage = true;
+    }
   }
 
 
-  const std::vector<rumDebugVariable>& GetRequestedVariablesRef()
+  void CoverageStop( const std::string& i_strName )
   {
-    return g_cRequestedVariables;
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      // The hook is removed from Update() if nothing else needs it
+      pcContext->m_bLineCoverage = false;
+    }
   }
 
 
-  rumDebugContext* GetVMByName( const std::string& i_strName )
+  SQInteger DetachVM( HSQUIRRELVM i_pcVM )
   {
-    const auto& iterVM{ std::find_if( g_cDebugContexts.begin(), g_cDebugContexts.end(),
-                                      [&]( const auto& iter )
-                                      {
-                                        return iter.m_strName.compare( i_strName ) == 0;
-                                      } ) };
-    if( iterVM != g_cDebugContexts.end() )
+    rumDebugContext* pcContext{ FindDebugContext( i_pcVM ) };
+    if( pcContext )
     {
-      return &*iterVM;
+      bool bPaused{ pcContext->m_bPaused };
+
+      pcContext->m_eStepDirective = rumDebugContext::StepDirective::Resume;
+      pcContext->m_bPauseRequested = false;
+      pcContext->m_bLineProfiling = false;
+      pcContext->m_bLineCoverage = false;
+      pcContext->m_bFunctionProfiling = false;
+      pcContext->m_bAttached = false;
+
+      if( pcContext->m_bSampling )
+      {
+        StopSampling( *pcContext );
+      }
+
+      if( pcContext->m_bTracing )
+      {
+        pcContext->m_bTracing = false;
+        rumDebugExport::TraceRemoveVM( *pcContext );
+      }
+
+      // Compiled conditions, log messages, and cached class methods hold references that must not outlive the VM
+      for( auto& iter : pcContext->m_mapBreakpointConditions )
+      {
+        rumDebugUtility::ReleaseExpression( i_pcVM, iter.second );
+      }
+
+      for( auto& iter : pcContext->m_mapLogMessages )
+      {
+        rumDebugUtility::ReleaseExpression( i_pcVM, iter.second.m_cExpression );
+      }
+
+      for( auto& iter : pcContext->m_mapWatchExpressions )
+      {
+        rumDebugUtility::ReleaseExpression( i_pcVM, iter.second );
+      }
+
+      for( auto& iter : pcContext->m_mapFunctionNameBreakpoints )
+      {
+        ReleaseClassMethods( i_pcVM, iter.second );
+      }
+
+      for( auto& iter : pcContext->m_vEvictedAccessPaths )
+      {
+        rumDebugUtility::ReleaseAccessPath( i_pcVM, *iter );
+      }
+
+      for( auto& iter : g_cWatchVariables )
+      {
+        if( iter.m_pcAccessPath )
+        {
+          rumDebugUtility::ReleaseAccessPath( i_pcVM, *iter.m_pcAccessPath );
+        }
+      }
+
+      pcContext->m_mapBreakpointConditions.clear();
+      pcContext->m_mapLogMessages.clear();
+      pcContext->m_mapWatchExpressions.clear();
+      pcContext->m_mapFunctionNameBreakpoints.clear();
+      pcContext->m_vEvictedAccessPaths.clear();
+
+      if( pcContext->m_bHookInstalled && !pcContext->m_bInDebugHook )
+      {
+        sq_setnativedebughook( i_pcVM, NULL );
+        pcContext->m_bHookInstalled = false;
+      }
+
+      if( bPaused )
+      {
+        RequestResume();
+      }
+
+      return SQ_OK;
     }
 
-    return nullptr;
+    return SQ_ERROR;
   }
 
 
-  const std::vector<rumDebugVariable> GetWatchedVariablesCopy()
+  void DetachVM( const std::string& i_strName )
   {
-    return g_cWatchVariables;
+    rumDebugContext* pcVM{ GetVMByName( i_strName ) };
+    if( pcVM )
+    {
+      DetachVM( pcVM->m_pcVM );
+    }
   }
 
 
-  const std::vector<rumDebugVariable>& GetWatchedVariablesRef()
+  void DrainLogMessages( const std::function<void( const char*, size_t )>& i_rfnCallback )
   {
-    return g_cWatchVariables;
+    g_cLogBuffer.Drain( i_rfnCallback );
   }
 
 
-  SQInteger IsDebuggerAttached( HSQUIRRELVM i_pcVM )
+  void EnableDebugInfo( HSQUIRRELVM i_pcVM, bool i_bEnable )
   {
-    const auto& iter{ std::find( g_cDebugContexts.begin(), g_cDebugContexts.end(), i_pcVM ) };
-    return iter != g_cDebugContexts.end() ? SQTrue : SQFalse;
+    sq_enabledebuginfo( i_pcVM, i_bEnable ? SQTrue : SQFalse );
   }
 
 
-  void NativeDebugHook( HSQUIRRELVM const i_pcVM, const SQInteger i_eHookType, const SQChar* i_strFileName,
-                        const SQInteger i_iLine, [[maybe_unused]] const SQChar* const i_strFunctionName )
+  bool EvaluateBreakpointCondition( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext, uint64_t i_uiKey,
+                                    const rumDebugBreakpoint& i_rcBreakpoint )
   {
-    if( SQ_LINEEXECUTION != i_eHookType )
+    if( i_rcBreakpoint.m_strCondition.empty() )
     {
-      return;
+      return true;
     }
 
-    auto iterContext{ std::find( g_cDebugContexts.begin(), g_cDebugContexts.end(), i_pcVM ) };
-    if( iterContext == g_cDebugContexts.end() )
+    auto& rcCondition{ io_rcContext.m_mapBreakpointConditions[i_uiKey] };
+    if( rcCondition.m_strExpression.compare( i_rcBreakpoint.m_strCondition ) != 0 )
     {
-      // The VM is not attached for debugging
-      return;
+      // The condition is new or has been edited since it was last compiled
+      rumDebugUtility::ReleaseExpression( i_pcVM, rcCondition );
+      rcCondition = rumDebugExpression();
+      rcCondition.m_strExpression = i_rcBreakpoint.m_strCondition;
+    }
+
+    if( rcCondition.m_bFailed )
+    {
+      // The failure has already been reported
+      return false;
     }
 
-    g_pcCurrentDebugContext = &*iterContext;
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
 
-    SQStackInfos cStackInfos;
-    SQInteger iStackLevel{ 0 };
-    while( SQ_SUCCEEDED( sq_stackinfos( i_pcVM, iStackLevel, &cStackInfos ) ) )
+    SQBool bResult{ SQFalse };
+    if( SQ_SUCCEEDED( rumDebugUtility::EvaluateExpression( i_pcVM, rcCondition, 0, CONDITION_TIME_BUDGET_MS ) ) )
     {
-      ++iStackLevel;
+      sq_tobool( i_pcVM, -1, &bResult );
+    }
+    else
+    {
+      // Condition errors never stop execution, they are only reported to the interface
+      ReportBreakpointError( i_rcBreakpoint, rcCondition.m_strError );
     }
 
-    std::filesystem::path fsFilePath( i_strFileName );
-    uint32_t uiLine{ static_cast<uint32_t>( i_iLine ) };
+    sq_settop( i_pcVM, iTop );
 
-    // Check for breakpoints first, even if there is a step directive because breakpoints override step directives
-    rumDebugBreakpoint cBreakpoint( fsFilePath, uiLine );
-    const auto& iterBP{ std::find_if( g_cBreakpoints.begin(), g_cBreakpoints.end(),
-                                      [&]( const auto& i_rcBreakpoint )
-      {
-        return i_rcBreakpoint.m_bEnabled && ( i_rcBreakpoint == cBreakpoint );
-      } ) };
+    return bResult ? true : false;
+  }
 
-    if( g_cBreakpoints.end() != iterBP )
+
+  void EvictAccessPath( std::shared_ptr<rumDebugAccessPath>&& io_pcPath )
+  {
+    if( !io_pcPath || nullptr == io_pcPath->m_pcVM )
     {
-#if DEBUG_OUTPUT
-      std::cout << "Breakpoint hit (type: " << static_cast<int32_t>( i_eHookType );
-      std::cout << ") source: " << i_strFileName;
-      std::cout << ") line: " << uiLine;
-      std::cout << ") function: " << i_strFunctionName << '\n';
-#endif // DEBUG_OUTPUT
+      return;
+    }
 
-      if( iterContext != g_cDebugContexts.end() )
-      {
-        SuspendVM( i_pcVM, *iterContext, uiLine, fsFilePath );
-      }
+    // A detached VM has already released the names interned in it
+    rumDebugContext* pcContext{ FindDebugContext( io_pcPath->m_pcVM ) };
+    if( pcContext && pcContext->m_bAttached )
+    {
+      pcContext->m_vEvictedAccessPaths.push_back( std::move( io_pcPath ) );
     }
+  }
 
-    switch( iterContext->m_eStepDirective )
+
+  void EvictWatchExpression( const std::string& i_strExpression )
+  {
+    for( auto& iter : g_cDebugContexts )
     {
-      case rumDebugContext::StepDirective::StepOver:
+      auto& rcvEvicted{ iter.m_vEvictedWatchExpressions };
+      if( iter.m_bAttached && std::find( rcvEvicted.begin(), rcvEvicted.end(), i_strExpression ) == rcvEvicted.end() )
       {
-        if( iStackLevel <= (SQInteger)iterContext->m_uiStepDirectiveStackLevel )
-        {
-          SuspendVM( i_pcVM, *iterContext, uiLine, fsFilePath );
-        }
-        break;
+        rcvEvicted.push_back( i_strExpression );
       }
+    }
+  }
+
+
+  bool ExportCollapsedStacks( const std::string& i_strName, rumDebugProfileSource i_eSource,
+                              const std::filesystem::path& i_fsFilePath )
+  {
+    auto pcCallTree{ GetCallTree( i_strName, i_eSource ) };
+    if( !pcCallTree || pcCallTree->m_vNodes.size() <= 1 )
+    {
+      return false;
+    }
+
+    rumDebugExport::ExportCollapsedStacks( std::move( pcCallTree ), i_eSource, i_fsFilePath );
+
+    return true;
+  }
+
+
+  bool ExportLineCoverage( const std::filesystem::path& i_fsFilePath )
+  {
+    std::vector<std::pair<std::string, uint32_t>> vFileIDs;
+
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxFileIDLock );
+
+      vFileIDs.assign( g_mapFileIDs.begin(), g_mapFileIDs.end() );
+    }
+
+    std::sort( vFileIDs.begin(), vFileIDs.end() );
+
+    std::vector<rumDebugExport::CoveredFile> vCoveredFiles;
+
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+      for( const auto& fileIter : vFileIDs )
+      {
+        rumDebugExport::CoveredFile cCoveredFile;
+
+        bool bCovered{ false };
+        for( const auto& contextIter : g_cDebugContexts )
+        {
+          bCovered |= contextIter.m_cLineCoverage.GetLines( fileIter.second, cCoveredFile.m_vLines );
+        }
+
+        if( bCovered )
+        {
+          cCoveredFile.m_fsFilePath = fileIter.first;
+          vCoveredFiles.push_back( std::move( cCoveredFile ) );
+        }
+      }
+    }
+
+    if( vCoveredFiles.empty() )
+    {
+      return false;
+    }
+
+    rumDebugExport::ExportLineCoverage( std::move( vCoveredFiles ), i_fsFilePath );
+
+    return true;
+  }
+
+
+  void FetchRequestedVariables( HSQUIRRELVM i_pcVM )
+  {
+    const auto IsValidHandle{ []( uint32_t i_uiHandle )
+    {
+      return i_uiHandle > 0 && i_uiHandle <= g_vVariableHandles.size();
+    } };
+
+    for( const uint64_t uiRequest : g_vRequestedChildCounts )
+    {
+      const auto uiHandle{ static_cast<uint32_t>( uiRequest ) };
+      if( IsValidHandle( uiHandle ) && !g_mapVariableChildren.count( uiHandle ) )
+      {
+        rumDebugVariableChildren cChildren;
+        cChildren.m_uiNumChildren = CountVariableChildren( i_pcVM, g_vVariableHandles[uiHandle - 1] );
+        g_mapVariableChildren.emplace( uiHandle, std::move( cChildren ) );
+      }
+    }
+
+    for( const uint64_t uiRequest : g_vRequestedChildPages )
+    {
+      const auto uiHandle{ static_cast<uint32_t>( uiRequest >> 32 ) };
+      const auto uiPage{ static_cast<uint32_t>( uiRequest ) };
+
+      // Pages are only requested once the children have been counted
+      const auto& iter{ g_mapVariableChildren.find( uiHandle ) };
+      if( IsValidHandle( uiHandle ) && iter != g_mapVariableChildren.end() && !iter->second.m_mapPages.count( uiPage ) )
+      {
+        BuildVariableChildren( i_pcVM, g_vVariableHandles[uiHandle - 1], uiPage, iter->second );
+      }
+    }
+
+    for( const uint64_t uiRequest : g_vRequestedDescriptions )
+    {
+      const auto uiHandle{ static_cast<uint32_t>( uiRequest ) };
+      if( IsValidHandle( uiHandle ) && !g_mapVariableDescriptions.count( uiHandle ) )
+      {
+        const rumDebugScopeTimer cFormatTimer( g_uiFormatNS );
+        g_mapVariableDescriptions.emplace( uiHandle,
+                                           rumDebugUtility::FormatVariable( i_pcVM, g_vVariableHandles[uiHandle - 1],
+                                                                            rumDebugInterface::WantsValuesAsHex() ) );
+      }
+    }
+
+    g_vRequestedChildCounts.clear();
+    g_vRequestedChildPages.clear();
+    g_vRequestedDescriptions.clear();
+  }
+
+
+  void FileClose( const std::filesystem::path& i_fsFilePath )
+  {
+    std::string strFilePath{ i_fsFilePath.generic_string() };
+
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    const auto& iter{ g_cOpenedFiles.find( strFilePath ) };
+    if( iter != g_cOpenedFiles.end() )
+    {
+      g_cOpenedFiles.erase( iter );
+    }
+
+    rumDebugInterface::RequestSettingsUpdate();
+  }
+
+
+  void FileOpen( const std::filesystem::path& i_fsFilePath, uint32_t i_uiLine )
+  {
+    std::string strFilePath{ i_fsFilePath.generic_string() };
+
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    // Determine if the file is already opened
+    const auto& iter{ g_cOpenedFiles.find( strFilePath ) };
+    if( iter == g_cOpenedFiles.end() )
+    {
+      // Open and cache the file contents
+      rumDebugFile cFile;
+      cFile.m_fsFilePath = i_fsFilePath;
+      cFile.m_strFilename = i_fsFilePath.filename().generic_string();
+
+      std::ifstream cInfile;
+      cInfile.open( cFile.m_fsFilePath.native().c_str() );
+
+      std::ostringstream cBuffer;
+      cBuffer << cInfile.rdbuf();
+      cFile.m_strData = cBuffer.str();
+
+      cFile.m_vStringOffsets.resize( 10000 );
+
+      size_t szLastOffset{ 0 };
+      size_t szCurrentOffset{ 0 };
+      size_t uiLongestLine{ rumDebugFile::s_uiMinimumColumns };
+
+      bool bInMultilineComment{ false };
+      uint32_t iMultilineCommentStart{ 0 };
+
+      uint32_t index{ 0 };
+
+      while( ( szCurrentOffset = cFile.m_strData.find( '\n', szLastOffset ) ) != std::string::npos )
+      {
+        cFile.m_vStringOffsets[++index] = ++szCurrentOffset;
+
+        std::string_view strLine{ std::string_view( cFile.m_strData ).substr( szLastOffset, szCurrentOffset - szLastOffset ) };
+        const size_t uiLineLength{ strLine.size() };
+        uiLongestLine = { std::max( uiLineLength, uiLongestLine ) };
+
+        // Parse multiline comment ranges
+        size_t iMultilineCommentStartSymbol{ strLine.find( "/*" ) };
+        if( !bInMultilineComment && iMultilineCommentStartSymbol != std::string::npos )
+        {
+          size_t iMultilineCommentEndSymbol{ strLine.find( "*/" ) };
+          while( iMultilineCommentStartSymbol != std::string::npos && iMultilineCommentEndSymbol != std::string::npos )
+          {
+            while( iMultilineCommentEndSymbol != std::string::npos && iMultilineCommentEndSymbol < iMultilineCommentStartSymbol )
+            {
+              // end before start, let's check if we have real closure in this line
+              iMultilineCommentEndSymbol = strLine.find( "*/", iMultilineCommentEndSymbol + 2 );
+            }
+            if( iMultilineCommentEndSymbol != std::string::npos )
+            {
+              // found a closure for multiline comment in same line, let's check that if we try to start a new multi line comment after this block
+              iMultilineCommentStartSymbol = strLine.find( "/*", iMultilineCommentEndSymbol + 2 );
+            }
+          }
+          if( iMultilineCommentStartSymbol != std::string::npos )
+          {
+            bInMultilineComment = true;
+            iMultilineCommentStart = index;
+          }
+        }
+        else if( bInMultilineComment && strLine.find( "*/" ) != std::string::npos )
+        {
+          rumDebugFile::MultilineComment cMultilineComment;
+          cMultilineComment.m_iStartLine = iMultilineCommentStart;
+          cMultilineComment.m_iEndLine = index;
+
+          cFile.m_vMultilineComments.emplace_back( std::move( cMultilineComment ) );
+
+          bInMultilineComment = false;
+        }
+
+        szLastOffset = szCurrentOffset;
+      }
+
+      // Add the last offset if there isn't a final '\n'
+      if( szLastOffset != cFile.m_strData.length() )
+      {
+        cFile.m_vStringOffsets[index++] = cFile.m_strData.length();
+      }
+
+      // Handle files that do not have a closing multiline comment
+      if( bInMultilineComment )
+      {
+        rumDebugFile::MultilineComment cMultilineComment;
+        cMultilineComment.m_iStartLine = iMultilineCommentStart;
+        cMultilineComment.m_iEndLine = index;
+
+        cFile.m_vMultilineComments.emplace_back( std::move( cMultilineComment ) );
+      }
+
+      cFile.m_vStringOffsets.resize( index + 1 );
+      cFile.m_uiLongestLine = uiLongestLine;
+
+      g_cOpenedFiles.insert( std::make_pair( strFilePath, std::move( cFile ) ) );
+      rumDebugInterface::RequestSettingsUpdate();
+    }
+
+    // Request a switch to the target file and line
+    rumDebugInterface::SetFileFocus( i_fsFilePath, i_uiLine );
+  }
+
+
+  const std::vector<rumDebugBreakpoint> GetBreakpointsCopy()
+  {
+    // Condition errors are reported from VM threads
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    return g_cBreakpoints;
+  }
+
+
+  const std::vector<rumDebugBreakpoint>& GetBreakpointsRef()
+  {
+    return g_cBreakpoints;
+  }
+
+
+  std::shared_ptr<const rumDebugCallTree> GetCallTree( const std::string& i_strName,
+                                                       rumDebugProfileSource i_eSource )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    const rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      const auto& rpcCallTree{ rumDebugProfileSource::Sampled == i_eSource ? pcContext->m_pcSampledCallTreeSnapshot
+                                                                           : pcContext->m_pcCallTreeSnapshot };
+      return std::atomic_load_explicit( &rpcCallTree, std::memory_order_acquire );
+    }
+
+    return nullptr;
+  }
+
+
+  const rumDebugContext* GetCurrentDebugContext()
+  {
+    return g_pcCurrentDebugContext;
+  }
+
+
+  const std::deque<rumDebugContext>& GetDebugContexts()
+  {
+    return g_cDebugContexts;
+  }
+
+
+  const std::vector<rumDebugFunctionBreakpoint> GetFunctionBreakpointsCopy()
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    return g_cFunctionBreakpoints;
+  }
+
+
+  const std::vector<rumDebugFunctionBreakpoint>& GetFunctionBreakpointsRef()
+  {
+    return g_cFunctionBreakpoints;
+  }
+
+
+  uint32_t GetLineCounts( const std::filesystem::path& i_fsFilePath, rumDebugProfileSource i_eSource,
+                          std::vector<uint32_t>& o_vCounts )
+  {
+    o_vCounts.clear();
+
+    const uint32_t uiFileID{ InternFileID( i_fsFilePath ) };
+
+    uint32_t uiMaxCount{ 0 };
+    for( const auto& iter : g_cDebugContexts )
+    {
+      const auto& rcLineCounts{ rumDebugProfileSource::Sampled == i_eSource ? iter.m_cSampledLineCounts
+                                                                            : iter.m_cLineCounts };
+      uiMaxCount = std::max( uiMaxCount, rcLineCounts.GetCounts( uiFileID, o_vCounts ) );
+    }
+
+    return uiMaxCount;
+  }
+
+
+  std::string GetLastExportError()
+  {
+    return rumDebugExport::GetLastError();
+  }
+
+
+  bool GetLineCoverage( const std::filesystem::path& i_fsFilePath, std::vector<uint64_t>& o_vLines )
+  {
+    o_vLines.clear();
+
+    const uint32_t uiFileID{ InternFileID( i_fsFilePath ) };
+
+    bool bCovered{ false };
+    for( const auto& iter : g_cDebugContexts )
+    {
+      bCovered |= iter.m_cLineCoverage.GetLines( uiFileID, o_vLines );
+    }
+
+    return bCovered;
+  }
+
+
+  const std::vector<rumDebugVariable>& GetLocalVariablesRef()
+  {
+    return g_cLocalVariables;
+  }
+
+
+  uint64_t GetNumDroppedLogMessages()
+  {
+    return g_cLogBuffer.GetNumDropped();
+  }
+
+
+  uint64_t GetNumDroppedSamples( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    const rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext && pcContext->m_pcSampleBuffer )
+    {
+      return pcContext->m_pcSampleBuffer->GetNumDropped();
+    }
+
+    return 0;
+  }
+
+
+  uint64_t GetNumDroppedTraceEvents()
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    uint64_t uiNumDropped{ 0 };
+    for( const auto& iter : g_cDebugContexts )
+    {
+      if( iter.m_pcTraceBuffer )
+      {
+        uiNumDropped += iter.m_pcTraceBuffer->GetNumDropped();
+      }
+    }
+
+    return uiNumDropped;
+  }
+
+
+  const std::map<std::string, rumDebugFile> GetOpenedFilesCopy()
+  {
+    return g_cOpenedFiles;
+  }
+
+
+  const std::map<std::string, rumDebugFile>& GetOpenedFilesRef()
+  {
+    return g_cOpenedFiles;
+  }
+
+
+  const std::vector<rumDebugVariable>& GetRequestedVariablesRef()
+  {
+    return g_cRequestedVariables;
+  }
+
+
+  uint32_t GetSampleRate()
+  {
+    return g_uiSampleRateHz.load( std::memory_order_relaxed );
+  }
+
+
+  rumDebugStats GetStats()
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugStats cStats{ CollectStats() };
+
+    // Counters only ever grow, so they never fall below the baseline
+    for( auto pMember : { &rumDebugStats::m_uiNumCallEvents, &rumDebugStats::m_uiNumReturnEvents,
+                          &rumDebugStats::m_uiNumLineEvents, &rumDebugStats::m_uiHookNS,
+                          &rumDebugStats::m_uiNumBreakpointChecks, &rumDebugStats::m_uiNumPauses,
+                          &rumDebugStats::m_uiPausedNS, &rumDebugStats::m_uiNumFormattedVariables,
+                          &rumDebugStats::m_uiNumReusedVariables, &rumDebugStats::m_uiFormatNS } )
+    {
+      cStats.*pMember -= g_cStatsBaseline.*pMember;
+    }
+
+    return cStats;
+  }
+
+
+  rumDebugContext* FindDebugContext( HSQUIRRELCONSTVM i_pcVM )
+  {
+    const auto& iter{ g_mapDebugContexts.find( i_pcVM ) };
+    return iter != g_mapDebugContexts.end() ? iter->second : nullptr;
+  }
+
+
+  uint32_t FindOrAddCallTreeNode( rumDebugCallTree& io_rcCallTree, std::unordered_map<uint64_t, uint32_t>& io_rmapNodes,
+                                  uint32_t i_uiParent, uint32_t i_uiFunction )
+  {
+    const uint64_t uiKey{ ( static_cast<uint64_t>( i_uiParent ) << 32 ) | i_uiFunction };
+    const auto& iter{ io_rmapNodes.find( uiKey ) };
+    if( iter != io_rmapNodes.end() )
+    {
+      return iter->second;
+    }
+
+    // First call through this path
+    const uint32_t uiNode{ io_rcCallTree.AddChild( i_uiParent, i_uiFunction ) };
+    io_rmapNodes.emplace( uiKey, uiNode );
+
+    return uiNode;
+  }
+
+
+  void FunctionBreakpointAdd( rumDebugFunctionBreakpoint i_cBreakpoint )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cFunctionBreakpoints.begin(), g_cFunctionBreakpoints.end(), i_cBreakpoint ) };
+    if( g_cFunctionBreakpoints.end() == iter && !i_cBreakpoint.m_strFunction.empty() )
+    {
+      g_cFunctionBreakpoints.emplace_back( std::move( i_cBreakpoint ) );
+      RebuildBreakpointIndex();
+
+      rumDebugInterface::RequestSettingsUpdate();
+    }
+  }
+
+
+  void FunctionBreakpointRemove( const rumDebugFunctionBreakpoint& i_rcBreakpoint )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cFunctionBreakpoints.begin(), g_cFunctionBreakpoints.end(), i_rcBreakpoint ) };
+    if( iter != g_cFunctionBreakpoints.end() )
+    {
+      g_cFunctionBreakpoints.erase( iter );
+      RebuildBreakpointIndex();
+
+      // The hook is removed on the next Update() if nothing else needs it
+
+      rumDebugInterface::RequestSettingsUpdate();
+    }
+  }
+
+
+  void FunctionBreakpointResetHits( const rumDebugFunctionBreakpoint& i_rcBreakpoint )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cFunctionBreakpoints.begin(), g_cFunctionBreakpoints.end(), i_rcBreakpoint ) };
+    if( iter != g_cFunctionBreakpoints.end() )
+    {
+      // The counter is shared with the published index, so no rebuild is needed
+      iter->m_pcNumHits->store( 0, std::memory_order_relaxed );
+    }
+  }
+
+
+  void FunctionBreakpointSetHitCount( const rumDebugFunctionBreakpoint& i_rcBreakpoint, uint32_t i_uiHitCount )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cFunctionBreakpoints.begin(), g_cFunctionBreakpoints.end(), i_rcBreakpoint ) };
+    if( iter != g_cFunctionBreakpoints.end() )
+    {
+      iter->m_uiHitCount = i_uiHitCount;
+      RebuildBreakpointIndex();
+
+      rumDebugInterface::RequestSettingsUpdate();
+    }
+  }
+
+
+  void FunctionBreakpointToggle( const rumDebugFunctionBreakpoint& i_rcBreakpoint )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cFunctionBreakpoints.begin(), g_cFunctionBreakpoints.end(), i_rcBreakpoint ) };
+    if( iter != g_cFunctionBreakpoints.end() )
+    {
+      iter->m_bEnabled = !iter->m_bEnabled;
+      RebuildBreakpointIndex();
+
+      rumDebugInterface::RequestSettingsUpdate();
+    }
+  }
+
+
+  bool FunctionHasBreakpoints( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext,
+                               const rumDebugBreakpointIndex& i_rcBreakpointIndex )
+  {
+    const uint32_t uiGeneration{ io_rcContext.m_uiBreakpointGeneration };
+
+    if( io_rcContext.m_bFunctionBreakpointsValid && io_rcContext.m_uiFunctionBreakpointsGeneration == uiGeneration )
+    {
+      return io_rcContext.m_bFunctionHasBreakpoints;
+    }
+
+    bool bHasBreakpoints{ true };
+
+    SQFunctionInfo cFunctionInfo;
+    if( SQ_SUCCEEDED( sq_getfunctioninfo( i_pcVM, 0, &cFunctionInfo ) ) )
+    {
+      auto& rcFunction{ io_rcContext.m_mapFunctionBreakpoints[cFunctionInfo.funcid] };
+      if( rcFunction.m_uiGeneration != uiGeneration || rcFunction.m_strSource != cFunctionInfo.source ||
+          rcFunction.m_iLine != cFunctionInfo.line )
+      {
+        // Squirrel doesn't expose where a function ends, so any breakpoint from its first line to the end of its file
+        // is treated as potentially inside of it
+        rcFunction.m_strSource = cFunctionInfo.source;
+        rcFunction.m_iLine = cFunctionInfo.line;
+        rcFunction.m_uiGeneration = uiGeneration;
+        const uint32_t uiFileID{ GetFileID( io_rcContext, cFunctionInfo.source ) };
+        const uint32_t uiLine{ static_cast<uint32_t>( std::max<SQInteger>( cFunctionInfo.line, 0 ) ) };
+        rcFunction.m_bHasBreakpoints = i_rcBreakpointIndex.HasBreakpointFrom( uiFileID, uiLine );
+      }
+
+      bHasBreakpoints = rcFunction.m_bHasBreakpoints;
+    }
+
+    io_rcContext.m_bFunctionHasBreakpoints = bHasBreakpoints;
+    io_rcContext.m_uiFunctionBreakpointsGeneration = uiGeneration;
+    io_rcContext.m_bFunctionBreakpointsValid = true;
+
+    return bHasBreakpoints;
+  }
+
+
+  void FunctionProfilerReset( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      // The call tree belongs to the VM's thread, so it is cleared from Update()
+      pcContext->m_bCallTreeResetRequested = true;
+    }
+  }
+
+
+  void FunctionProfilerStart( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext && pcContext->m_bAttached )
+    {
+      pcContext->m_bFunctionProfiling = true;
+    }
+  }
+
+
+  void FunctionProfilerStop( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      // The final timings are published and the hook removed from Update()
+      pcContext->m_bFunctionProfiling = false;
+    }
+  }
+
+
+  uint32_t GetFileID( rumDebugContext& io_rcContext, const SQChar* i_strSource )
+  {
+    // Consecutive events nearly always come from the same source, so check that first
+    if( i_strSource == io_rcContext.m_strLastSource )
+    {
+      return io_rcContext.m_uiLastFileID;
+    }
+
+    auto iter{ io_rcContext.m_mapSourceFileIDs.find( i_strSource ) };
+    if( iter == io_rcContext.m_mapSourceFileIDs.end() || iter->second.m_strSource.compare( i_strSource ) != 0 )
+    {
+      // First time seeing this source name, or its pointer has since been reused for a different name
+      rumDebugContext::SourceFileID cSourceFileID;
+      cSourceFileID.m_strSource = i_strSource;
+      cSourceFileID.m_uiFileID = InternFileID( std::filesystem::path( i_strSource ) );
+
+      iter = io_rcContext.m_mapSourceFileIDs.insert_or_assign( i_strSource, std::move( cSourceFileID ) ).first;
+    }
+
+    io_rcContext.m_strLastSource = i_strSource;
+    io_rcContext.m_uiLastFileID = iter->second.m_uiFileID;
+
+    return io_rcContext.m_uiLastFileID;
+  }
+
+
+  uint32_t GetProfileFunctionID( rumDebugContext& io_rcContext, const SQFunctionInfo& i_rcFunctionInfo )
+  {
+    auto& rcFunctionID{ io_rcContext.m_mapProfileFunctionIDs[i_rcFunctionInfo.funcid] };
+    if( rcFunctionID.m_bResolved && rcFunctionID.m_strSource == i_rcFunctionInfo.source &&
+        rcFunctionID.m_strFunction == i_rcFunctionInfo.name )
+    {
+      return rcFunctionID.m_uiFunction;
+    }
+
+    // First call of this prototype, or its address has since been reused for another function
+    const SQChar* strSource{ i_rcFunctionInfo.source ? i_rcFunctionInfo.source : "" };
+    const SQChar* strFunction{ i_rcFunctionInfo.name ? i_rcFunctionInfo.name : "" };
+
+    std::string strKey{ strSource };
+    strKey += ':';
+    strKey += std::to_string( i_rcFunctionInfo.line );
+    strKey += ':';
+    strKey += strFunction;
+
+    auto iter{ io_rcContext.m_mapProfileFunctionNames.find( strKey ) };
+    if( iter == io_rcContext.m_mapProfileFunctionNames.end() )
+    {
+      const uint32_t uiFunction{ io_rcContext.m_cProfileFunctions.Add(
+        { strSource, strFunction, static_cast<int32_t>( i_rcFunctionInfo.line ) } ) };
+      iter = io_rcContext.m_mapProfileFunctionNames.emplace( std::move( strKey ), uiFunction ).first;
+    }
+
+    rcFunctionID.m_strSource = i_rcFunctionInfo.source;
+    rcFunctionID.m_strFunction = i_rcFunctionInfo.name;
+    rcFunctionID.m_uiFunction = iter->second;
+    rcFunctionID.m_bResolved = true;
+
+    return rcFunctionID.m_uiFunction;
+  }
+
+
+  rumDebugContext* GetVMByName( const std::string& i_strName )
+  {
+    const auto& iterVM{ std::find_if( g_cDebugContexts.begin(), g_cDebugContexts.end(),
+                                      [&]( const auto& iter )
+                                      {
+                                        return iter.m_strName.compare( i_strName ) == 0;
+                                      } ) };
+    if( iterVM != g_cDebugContexts.end() )
+    {
+      return &*iterVM;
+    }
+
+    return nullptr;
+  }
+
+
+  bool GetNumVariableChildren( uint32_t i_uiHandle, uint32_t& o_uiNumChildren )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    const auto& iter{ g_mapVariableChildren.find( i_uiHandle ) };
+    if( iter != g_mapVariableChildren.end() )
+    {
+      o_uiNumChildren = iter->second.m_uiNumChildren;
+      return true;
+    }
+
+    QueueVariableFetch( g_vRequestedChildCounts, i_uiHandle, i_uiHandle );
+
+    return false;
+  }
+
+
+  bool GetVariableChildren( uint32_t i_uiHandle, uint32_t i_uiPage, std::vector<rumDebugVariable>& o_vChildren )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    const auto& iter{ g_mapVariableChildren.find( i_uiHandle ) };
+    if( iter == g_mapVariableChildren.end() )
+    {
+      // The children must be counted first
+      QueueVariableFetch( g_vRequestedChildCounts, i_uiHandle, i_uiHandle );
+      return false;
+    }
+
+    const auto& pageIter{ iter->second.m_mapPages.find( i_uiPage ) };
+    if( pageIter != iter->second.m_mapPages.end() )
+    {
+      o_vChildren = pageIter->second;
+      return true;
+    }
+
+    QueueVariableFetch( g_vRequestedChildPages, ( static_cast<uint64_t>( i_uiHandle ) << 32 ) | i_uiPage,
+                        i_uiHandle );
+
+    return false;
+  }
+
+
+  bool GetVariableDescription( uint32_t i_uiHandle, std::string& o_strDescription )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    const auto& iter{ g_mapVariableDescriptions.find( i_uiHandle ) };
+    if( iter != g_mapVariableDescriptions.end() )
+    {
+      o_strDescription = iter->second;
+      return true;
+    }
+
+    QueueVariableFetch( g_vRequestedDescriptions, i_uiHandle, i_uiHandle );
+
+    return false;
+  }
+
+
+  const std::vector<rumDebugVariable> GetWatchedVariablesCopy()
+  {
+    return g_cWatchVariables;
+  }
+
+
+  const std::vector<rumDebugVariable>& GetWatchedVariablesRef()
+  {
+    return g_cWatchVariables;
+  }
+
+
+  uint32_t InternFileID( const std::filesystem::path& i_fsFilePath )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxFileIDLock );
+
+    // File ids are dense so that they can directly index per-file tables
+    const auto uiFileID{ static_cast<uint32_t>( g_mapFileIDs.size() ) };
+    return g_mapFileIDs.try_emplace( i_fsFilePath.generic_string(), uiFileID ).first->second;
+  }
+
+
+  void JoinStoppedSamplerThreads()
+  {
+    std::vector<std::thread> vSamplerThreads;
+
+    {
+      std::lock_guard<std::mutex> cSamplerLockGuard( g_mtxSamplerLock );
+      vSamplerThreads.swap( g_vStoppedSamplerThreads );
+    }
+
+    // The sampler thread only ever takes the sampler lock, which is no longer held
+    for( auto& iter : vSamplerThreads )
+    {
+      iter.join();
+    }
+  }
+
+
+  bool IsCallToClassMethod( HSQUIRRELVM i_pcVM, const rumDebugFunctionBreakpoint& i_rcBreakpoint,
+                            HSQOBJECT& io_rsqMethod )
+  {
+    if( sq_isnull( io_rsqMethod ) )
+    {
+      const SQInteger iTop{ sq_gettop( i_pcVM ) };
+
+      // Fetch the method from the class in the root table. It stays null, and is fetched again on the next call, until
+      // the class has been defined.
+      sq_pushroottable( i_pcVM );
+      rumDebugUtility::PushString( i_pcVM, i_rcBreakpoint.m_strClass );
+      if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) && ( sq_gettype( i_pcVM, -1 ) == OT_CLASS ) )
+      {
+        rumDebugUtility::PushString( i_pcVM, i_rcBreakpoint.m_strFunction );
+        if( SQ_SUCCEEDED( sq_get( i_pcVM, -2 ) ) && ( sq_gettype( i_pcVM, -1 ) == OT_CLOSURE ) )
+        {
+          sq_getstackobj( i_pcVM, -1, &io_rsqMethod );
+          sq_addref( i_pcVM, &io_rsqMethod );
+        }
+      }
+
+      sq_settop( i_pcVM, iTop );
+
+      if( sq_isnull( io_rsqMethod ) )
+      {
+        return false;
+      }
+    }
+
+    // Derived classes share the closures of the methods they inherit, while overrides are different closures
+    return io_rsqMethod._unVal.pClosure == _closure( i_pcVM->ci->_closure );
+  }
+
+
+  SQInteger IsDebuggerAttached( HSQUIRRELVM i_pcVM )
+  {
+    return FindDebugContext( i_pcVM ) ? SQTrue : SQFalse;
+  }
+
+
+  bool IsHookTimingEnabled()
+  {
+    return g_bTimeDebugHook.load( std::memory_order_relaxed );
+  }
+
+
+  bool IsTracing()
+  {
+    return rumDebugExport::IsTracing();
+  }
+
+
+  void LineProfilerReset( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      pcContext->m_cLineCounts.Reset();
+    }
+  }
+
+
+  void LineProfilerStart( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext && pcContext->m_bAttached )
+    {
+      pcContext->m_bLineProfiling = true;
+    }
+  }
+
+
+  void LineProfilerStop( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      // The hook is removed from Update() if nothing else needs it
+      pcContext->m_bLineProfiling = false;
+    }
+  }
+
+
+  void LogBreakpointMessage( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext, uint64_t i_uiKey,
+                             const rumDebugBreakpoint& i_rcBreakpoint, const SQChar* i_strFileName, uint32_t i_uiLine )
+  {
+    auto& rcLogMessage{ io_rcContext.m_mapLogMessages[i_uiKey] };
+    if( rcLogMessage.m_strTemplate.compare( i_rcBreakpoint.m_strLogMessage ) != 0 )
+    {
+      // The message is new or has been edited since it was last compiled
+      rumDebugUtility::ReleaseExpression( i_pcVM, rcLogMessage.m_cExpression );
+      rcLogMessage.m_cExpression = rumDebugExpression();
+      rcLogMessage.m_cExpression.m_strExpression = rumDebugUtility::BuildMessageExpression( i_rcBreakpoint.m_strLogMessage );
+      rcLogMessage.m_strTemplate = i_rcBreakpoint.m_strLogMessage;
+    }
+
+    auto& rcExpression{ rcLogMessage.m_cExpression };
+    const bool bFailed{ rcExpression.m_bFailed };
+
+    const SQInteger iTop{ sq_gettop( i_pcVM ) };
+
+    const SQChar* strMessage{ nullptr };
+    if( SQ_FAILED( rumDebugUtility::EvaluateExpression( i_pcVM, rcExpression, 0, CONDITION_TIME_BUDGET_MS ) ) ||
+        SQ_FAILED( sq_getstring( i_pcVM, -1, &strMessage ) ) )
+    {
+      // Log the error in place of the message so that the failure is visible where the output is expected
+      strMessage = rcExpression.m_strError.c_str();
+
+      if( !bFailed )
+      {
+        ReportBreakpointError( i_rcBreakpoint, rcExpression.m_strError );
+      }
+    }
+
+    // Only the file name is logged, the full path is available from the Breakpoints tab
+    const SQChar* strFileName{ i_strFileName };
+    for( const SQChar* strChar{ i_strFileName }; *strChar; ++strChar )
+    {
+      if( '/' == *strChar || '\\' == *strChar )
+      {
+        strFileName = strChar + 1;
+      }
+    }
+
+    // Never waits on the interface, a full buffer drops the message
+    g_cLogBuffer.Push( "[%s] %s:%u %s", io_rcContext.m_strName.c_str(), strFileName, i_uiLine, strMessage );
+
+    sq_settop( i_pcVM, iTop );
+  }
+
+
+  void NativeDebugHook( HSQUIRRELVM const i_pcVM, const SQInteger i_eHookType, const SQChar* i_strFileName,
+                        const SQInteger i_iLine, const SQChar* const i_strFunctionName )
+  {
+    rumDebugContext* pcContext{ FindDebugContext( i_pcVM ) };
+    if( nullptr == pcContext || !pcContext->m_bAttached )
+    {
+      // The VM is not attached for debugging, and the hook is awaiting removal
+      return;
+    }
+
+    rumDebugHookStats& rcStats{ pcContext->m_cHookStats };
+    const rumDebugHookTimer cHookTimer( rcStats, g_bTimeDebugHook.load( std::memory_order_relaxed ) );
+
+    bool bResynced{ false };
+    if( pcContext->m_bResyncCallDepth )
+    {
+      // The stack already reflects a call being entered or a return being left at this point
+      pcContext->m_iCallDepth = CountCallDepth( i_pcVM );
+      pcContext->m_bResyncCallDepth = false;
+      bResynced = true;
+    }
+
+    switch( i_eHookType )
+    {
+      case SQ_FUNCTIONCALL:
+        rumDebugHookStats::Add( rcStats.m_uiNumCallEvents, 1 );
+
+        if( !bResynced )
+        {
+          ++pcContext->m_iCallDepth;
+        }
+
+        // The called function is now executing
+        pcContext->m_bFunctionBreakpointsValid = false;
+
+        if( i_strFunctionName )
+        {
+          const rumDebugBreakpointIndex& rcBreakpointIndex{ AcquireBreakpointIndex( *pcContext ) };
+          if( rcBreakpointIndex.HasFunctionBreakpoints() )
+          {
+            rumDebugHookStats::Add( rcStats.m_uiNumBreakpointChecks, 1 );
+            CheckFunctionBreakpoints( i_pcVM, *pcContext, rcBreakpointIndex, i_strFunctionName );
+          }
+        }
+
+        if( pcContext->m_bFunctionProfiling || pcContext->m_bTracing )
+        {
+          ProfileCall( i_pcVM, *pcContext );
+        }
+        return;
+
+      case SQ_FUNCTIONRETURN:
+        rumDebugHookStats::Add( rcStats.m_uiNumReturnEvents, 1 );
+
+        if( pcContext->m_bFunctionProfiling || pcContext->m_bTracing )
+        {
+          ProfileReturn( *pcContext );
+        }
+
+        --pcContext->m_iCallDepth;
+
+        // The calling function resumes executing
+        pcContext->m_bFunctionBreakpointsValid = false;
+        return;
+
+      case SQ_LINEEXECUTION:
+        rumDebugHookStats::Add( rcStats.m_uiNumLineEvents, 1 );
+        break;
+
+      default:
+        return;
+    }
+
+    g_pcCurrentDebugContext = pcContext;
+
+    if( nullptr == i_strFileName )
+    {
+      // Nothing can be shown for code without a source name
+      return;
+    }
+
+    const uint32_t uiLine{ static_cast<uint32_t>( i_iLine ) };
+
+    if( pcContext->m_bLineProfiling )
+    {
+      pcContext->m_cLineCounts.Increment( GetFileID( *pcContext, i_strFileName ), uiLine );
+    }
+
+    if( pcContext->m_bLineCoverage )
+    {
+      pcContext->m_cLineCoverage.Mark( GetFileID( *pcContext, i_strFileName ), uiLine );
+    }
+
+    if( pcContext->m_bSampleRequested.load( std::memory_order_relaxed ) )
+    {
+      CaptureSample( i_pcVM, *pcContext, i_strFileName, uiLine );
+    }
+
+    if( pcContext->m_bPauseRequested )
+    {
+      SuspendVM( i_pcVM, *pcContext, uiLine, std::filesystem::path( i_strFileName ) );
+      return;
+    }
+
+    const bool bStepping{ pcContext->m_eStepDirective != rumDebugContext::StepDirective::Resume };
+
+    const rumDebugBreakpointIndex& rcBreakpointIndex{ AcquireBreakpointIndex( *pcContext ) };
+
+    if( !bStepping &&
+        ( rcBreakpointIndex.IsEmpty() || !FunctionHasBreakpoints( i_pcVM, *pcContext, rcBreakpointIndex ) ) )
+    {
+      // Nothing can stop execution in this function
+      return;
+    }
+
+    // Check for breakpoints first, even if there is a step directive because breakpoints override step directives
+    const uint32_t uiFileID{ GetFileID( *pcContext, i_strFileName ) };
+    if( !rcBreakpointIndex.IsEmpty() )
+    {
+      rumDebugHookStats::Add( rcStats.m_uiNumBreakpointChecks, 1 );
+    }
+
+    if( !rcBreakpointIndex.IsEmpty() && rcBreakpointIndex.HasBreakpoint( uiFileID, uiLine ) )
+    {
+      const uint64_t uiKey{ rumDebugBreakpointIndex::MakeKey( uiFileID, uiLine ) };
+      const rumDebugBreakpoint* pcBreakpoint{ rcBreakpointIndex.FindDetailedBreakpoint( uiFileID, uiLine ) };
+      if( nullptr == pcBreakpoint || EvaluateBreakpointCondition( i_pcVM, *pcContext, uiKey, *pcBreakpoint ) )
+      {
+        if( pcBreakpoint && !pcBreakpoint->m_strLogMessage.empty() )
+        {
+          // Logpoints never suspend execution, though an active step directive still can below
+          LogBreakpointMessage( i_pcVM, *pcContext, uiKey, *pcBreakpoint, i_strFileName, uiLine );
+        }
+        else
+        {
+#if DEBUG_OUTPUT
+          std::cout << "Breakpoint hit (type: " << static_cast<int32_t>( i_eHookType );
+          std::cout << ") source: " << i_strFileName;
+          std::cout << ") line: " << uiLine;
+          std::cout << ") function: " << i_strFunctionName << '\n';
+#endif // DEBUG_OUTPUT
+
+          SuspendVM( i_pcVM, *pcContext, uiLine, std::filesystem::path( i_strFileName ) );
+
+          // Any step directive issued while suspended applies from the next line onward
+          return;
+        }
+      }
+    }
+
+    const int32_t iCallDepth{ pcContext->m_iCallDepth };
+    const int32_t iStepDepth{ pcContext->m_iStepDirectiveCallDepth };
+
+    switch( pcContext->m_eStepDirective )
+    {
+      case rumDebugContext::StepDirective::StepOver:
+      {
+        if( iCallDepth <= iStepDepth )
+        {
+          SuspendVM( i_pcVM, *pcContext, uiLine, std::filesystem::path( i_strFileName ) );
+        }
+        break;
+      }
+
+      case rumDebugContext::StepDirective::StepInto:
+      {
+        if( iCallDepth >= iStepDepth )
+        {
+          SuspendVM( i_pcVM, *pcContext, uiLine, std::filesystem::path( i_strFileName ) );
+        }
+        break;
+      }
+
+      case rumDebugContext::StepDirective::StepOut:
+      {
+        if( iCallDepth < iStepDepth )
+        {
+          SuspendVM( i_pcVM, *pcContext, uiLine, std::filesystem::path( i_strFileName ) );
+        }
+        break;
+      }
+
+      default:
+        break;
+    }
+  }
+
+
+  void ProfileCall( HSQUIRRELVM i_pcVM, rumDebugContext& io_rcContext )
+  {
+    SQFunctionInfo cFunctionInfo;
+    if( SQ_FAILED( sq_getfunctioninfo( i_pcVM, 0, &cFunctionInfo ) ) )
+    {
+      return;
+    }
+
+    const uint32_t uiFunction{ GetProfileFunctionID( io_rcContext, cFunctionInfo ) };
+
+    if( io_rcContext.m_bTracing )
+    {
+      io_rcContext.m_pcTraceBuffer->Push( { rumDebugTraceEvent::ToTimeNS( std::chrono::steady_clock::now() ), 0,
+                                            uiFunction, 0, io_rcContext.m_iCallDepth,
+                                            rumDebugTraceEvent::Type::Call } );
+
+      if( !io_rcContext.m_bFunctionProfiling )
+      {
+        return;
+      }
+    }
+
+    auto& rvStack{ io_rcContext.m_vProfileStack };
+    const uint32_t uiParent{ rvStack.empty() ? 0 : rvStack.back().m_uiNode };
+    const uint32_t uiNode{ FindOrAddCallTreeNode( io_rcContext.m_cCallTree, io_rcContext.m_mapCallTreeNodes, uiParent,
+                                                  uiFunction ) };
+
+    // The clock is read last so that the profiler's own bookkeeping isn't counted against the call
+    rvStack.push_back( { uiNode, io_rcContext.m_iCallDepth, std::chrono::steady_clock::now(), 0 } );
+  }
+
+
+  void ProfileReturn( rumDebugContext& io_rcContext )
+  {
+    const auto tNow{ std::chrono::steady_clock::now() };
+
+    if( io_rcContext.m_bTracing )
+    {
+      // Dropped when the buffer is full, as is the call. The writer matches returns to calls by call depth.
+      io_rcContext.m_pcTraceBuffer->Push( { rumDebugTraceEvent::ToTimeNS( tNow ), 0, 0, 0, io_rcContext.m_iCallDepth,
+                                            rumDebugTraceEvent::Type::Return } );
+
+      if( !io_rcContext.m_bFunctionProfiling )
+      {
+        return;
+      }
+    }
+
+    auto& rvStack{ io_rcContext.m_vProfileStack };
+
+    // Frames deeper than the returning call never saw their returns, such as calls into a generator that suspended
+    while( !rvStack.empty() && rvStack.back().m_iCallDepth > io_rcContext.m_iCallDepth )
+    {
+      rvStack.pop_back();
+    }
+
+    if( rvStack.empty() || rvStack.back().m_iCallDepth != io_rcContext.m_iCallDepth )
+    {
+      // The returning call was entered before profiling started
+      return;
+    }
+
+    const rumDebugContext::ProfileFrame& rcFrame{ rvStack.back() };
+    const int64_t iElapsedNS{ std::chrono::duration_cast<std::chrono::nanoseconds>( tNow - rcFrame.m_tStart ).count() };
+
+    auto& rcNode{ io_rcContext.m_cCallTree.m_vNodes[rcFrame.m_uiNode] };
+    ++rcNode.m_uiNumCalls;
+    rcNode.m_iInclusiveNS += iElapsedNS;
+    rcNode.m_iExclusiveNS += iElapsedNS - rcFrame.m_iChildNS;
+
+    rvStack.pop_back();
+
+    if( !rvStack.empty() )
+    {
+      rvStack.back().m_iChildNS += iElapsedNS;
+    }
+
+    io_rcContext.m_bCallTreeChanged = true;
+  }
+
+
+  void PublishCallTree( rumDebugContext& io_rcContext )
+  {
+    const auto tNow{ std::chrono::steady_clock::now() };
+
+    io_rcContext.m_cProfileFunctions.CopyTo( io_rcContext.m_cCallTree.m_vFunctions );
+
+    auto pcCallTree{ std::make_shared<rumDebugCallTree>( io_rcContext.m_cCallTree ) };
+
+    // Each executing call has so far spent the elapsed time of the call it made in that call
+    int64_t iInnerElapsedNS{ 0 };
+    for( auto iter{ io_rcContext.m_vProfileStack.rbegin() }; iter != io_rcContext.m_vProfileStack.rend(); ++iter )
+    {
+      const int64_t iElapsedNS{ std::chrono::duration_cast<std::chrono::nanoseconds>( tNow - iter->m_tStart ).count() };
+
+      auto& rcNode{ pcCallTree->m_vNodes[iter->m_uiNode] };
+      rcNode.m_iInclusiveNS += iElapsedNS;
+      rcNode.m_iExclusiveNS += iElapsedNS - iter->m_iChildNS - iInnerElapsedNS;
+
+      iInnerElapsedNS = iElapsedNS;
+    }
+
+    std::atomic_store_explicit( &io_rcContext.m_pcCallTreeSnapshot,
+                                std::shared_ptr<const rumDebugCallTree>( std::move( pcCallTree ) ),
+                                std::memory_order_release );
+
+    io_rcContext.m_tCallTreeSnapshot = tNow;
+    io_rcContext.m_bCallTreeChanged = false;
+  }
+
+
+  void PublishSampledCallTree( rumDebugContext& io_rcContext )
+  {
+    io_rcContext.m_cProfileFunctions.CopyTo( io_rcContext.m_cSampledCallTree.m_vFunctions );
+
+    std::atomic_store_explicit( &io_rcContext.m_pcSampledCallTreeSnapshot,
+                                std::make_shared<const rumDebugCallTree>( io_rcContext.m_cSampledCallTree ),
+                                std::memory_order_release );
+
+    io_rcContext.m_tSampledCallTreeSnapshot = std::chrono::steady_clock::now();
+    io_rcContext.m_bSampledCallTreeChanged = false;
+  }
+
+
+  bool PushVariableIterable( HSQUIRRELVM i_pcVM, HSQOBJECT i_sqObject )
+  {
+    sq_pushobject( i_pcVM, i_sqObject );
+
+    // An instance's members are iterated through its class, while their values are fetched from the instance
+    if( sq_type( i_sqObject ) == OT_INSTANCE )
+    {
+      if( SQ_FAILED( sq_getclass( i_pcVM, -1 ) ) )
+      {
+        sq_poptop( i_pcVM );
+        return false;
+      }
+
+      sq_remove( i_pcVM, -2 );
+    }
+
+    return true;
+  }
+
+
+  void QueueVariableFetch( std::vector<uint64_t>& io_vRequests, uint64_t i_uiRequest, uint32_t i_uiHandle )
+  {
+    // Fetches can only be made while the VM that holds the handle is paused
+    if( !g_pcCurrentDebugContext || !g_pcCurrentDebugContext->m_bPaused || 0 == i_uiHandle ||
+        i_uiHandle > g_vVariableHandles.size() )
+    {
+      return;
+    }
+
+    if( std::find( io_vRequests.begin(), io_vRequests.end(), i_uiRequest ) == io_vRequests.end() )
+    {
+      io_vRequests.push_back( i_uiRequest );
+      g_pcCurrentDebugContext->m_bFetchVariables = true;
+      s_cvDebugLock.notify_all();
+    }
+  }
+
+
+  void RebuildBreakpointIndex()
+  {
+    auto pcBreakpointIndex{ std::make_shared<rumDebugBreakpointIndex>() };
+
+    for( const auto& iter : g_cBreakpoints )
+    {
+      if( iter.m_bEnabled )
+      {
+        pcBreakpointIndex->Add( InternFileID( iter.m_fsFilepath ), iter );
+      }
+    }
+
+    for( const auto& iter : g_cFunctionBreakpoints )
+    {
+      if( iter.m_bEnabled )
+      {
+        pcBreakpointIndex->AddFunction( iter );
+      }
+    }
+
+    // Publish the new index, which VM threads pick up on their next hook event once they see the generation change
+    std::shared_ptr<const rumDebugBreakpointIndex> pcPublishedIndex{ std::move( pcBreakpointIndex ) };
+    std::atomic_store_explicit( &g_pcBreakpointIndex, std::move( pcPublishedIndex ), std::memory_order_release );
+    g_uiBreakpointGeneration.fetch_add( 1, std::memory_order_release );
+  }
+
+
+  void ReportBreakpointError( const rumDebugBreakpoint& i_rcBreakpoint, const std::string& i_strError )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    auto iter{ std::find( g_cBreakpoints.begin(), g_cBreakpoints.end(), i_rcBreakpoint ) };
+    if( iter != g_cBreakpoints.end() && iter->m_strError.compare( i_strError ) != 0 )
+    {
+      iter->m_strError = i_strError;
+    }
+  }
+
+
+  void RegisterVM( HSQUIRRELVM i_pcVM, const std::string& i_strName )
+  {
+    AttachVM( i_pcVM, i_strName );
+  }
 
-      case rumDebugContext::StepDirective::StepInto:
-      {
-        if( iStackLevel >= (SQInteger)iterContext->m_uiStepDirectiveStackLevel )
-        {
-          SuspendVM( i_pcVM, *iterContext, uiLine, fsFilePath );
-        }
-        break;
-      }
 
-      case rumDebugContext::StepDirective::StepOut:
+  void ReleaseClassMethods( HSQUIRRELVM i_pcVM, rumDebugContext::FunctionNameBreakpoints& io_rcFunction )
+  {
+    for( auto& iter : io_rcFunction.m_vMethods )
+    {
+      if( !sq_isnull( iter ) )
       {
-        if( iStackLevel < (SQInteger)iterContext->m_uiStepDirectiveStackLevel )
-        {
-          SuspendVM( i_pcVM, *iterContext, uiLine, fsFilePath );
-        }
-        break;
+        sq_release( i_pcVM, &iter );
       }
     }
+
+    io_rcFunction.m_vMethods.clear();
   }
 
 
-  void RegisterVM( HSQUIRRELVM i_pcVM, const std::string& i_strName )
+  void ReleaseVariableHandles( HSQUIRRELVM i_pcVM )
   {
-    AttachVM( i_pcVM, i_strName );
+    for( auto& iter : g_vVariableHandles )
+    {
+      sq_release( i_pcVM, &iter );
+    }
+
+    g_vVariableHandles.clear();
+    g_mapVariableHandles.clear();
+    g_mapVariableChildren.clear();
+    g_mapVariableDescriptions.clear();
+    g_vRequestedChildCounts.clear();
+    g_vRequestedChildPages.clear();
+    g_vRequestedDescriptions.clear();
   }
 
 
@@ -658,6 +2608,18 @@ namespace rumDebugVM
   }
 
 
+  void RequestPauseVM( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext && pcContext->m_bAttached && !pcContext->m_bPaused )
+    {
+      pcContext->m_bPauseRequested = true;
+    }
+  }
+
+
   void RequestResume()
   {
     std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
@@ -678,8 +2640,7 @@ namespace rumDebugVM
     if( g_pcCurrentDebugContext )
     {
       g_pcCurrentDebugContext->m_eStepDirective = rumDebugContext::StepDirective::StepInto;
-      g_pcCurrentDebugContext->m_uiStepDirectiveStackLevel =
-        static_cast<uint32_t>( g_pcCurrentDebugContext->m_vCallstack.size() );
+      g_pcCurrentDebugContext->m_iStepDirectiveCallDepth = g_pcCurrentDebugContext->m_iCallDepth;
     }
 
     s_cvDebugLock.notify_all();
@@ -693,8 +2654,7 @@ namespace rumDebugVM
     if( g_pcCurrentDebugContext )
     {
       g_pcCurrentDebugContext->m_eStepDirective = rumDebugContext::StepDirective::StepOut;
-      g_pcCurrentDebugContext->m_uiStepDirectiveStackLevel =
-        static_cast<uint32_t>( g_pcCurrentDebugContext->m_vCallstack.size() );
+      g_pcCurrentDebugContext->m_iStepDirectiveCallDepth = g_pcCurrentDebugContext->m_iCallDepth;
     }
 
     s_cvDebugLock.notify_all();
@@ -708,8 +2668,7 @@ namespace rumDebugVM
     if( g_pcCurrentDebugContext )
     {
       g_pcCurrentDebugContext->m_eStepDirective = rumDebugContext::StepDirective::StepOver;
-      g_pcCurrentDebugContext->m_uiStepDirectiveStackLevel =
-        static_cast<uint32_t>( g_pcCurrentDebugContext->m_vCallstack.size() );
+      g_pcCurrentDebugContext->m_iStepDirectiveCallDepth = g_pcCurrentDebugContext->m_iCallDepth;
     }
 
     s_cvDebugLock.notify_all();
@@ -744,9 +2703,224 @@ namespace rumDebugVM
   }
 
 
+  void SamplerReset( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( pcContext )
+    {
+      std::lock_guard<std::mutex> cSamplerLockGuard( g_mtxSamplerLock );
+
+      pcContext->m_cSampledLineCounts.Reset();
+      pcContext->m_cSampledCallTree.ClearNodes();
+      pcContext->m_mapSampledCallTreeNodes.clear();
+
+      PublishSampledCallTree( *pcContext );
+    }
+  }
+
+
+  void SamplerStart( const std::string& i_strName )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+    if( nullptr == pcContext || !pcContext->m_bAttached || pcContext->m_bSampling )
+    {
+      return;
+    }
+
+    if( !pcContext->m_pcSampleBuffer )
+    {
+      pcContext->m_pcSampleBuffer = std::make_unique<rumDebugSampleBuffer>();
+    }
+
+    {
+      std::lock_guard<std::mutex> cSamplerLockGuard( g_mtxSamplerLock );
+
+      g_vSampledContexts.push_back( pcContext );
+
+      if( !g_cSamplerThread.joinable() )
+      {
+        g_cSamplerThread = std::thread( SamplerThread, g_uiSamplerGeneration );
+      }
+    }
+
+    pcContext->m_bSampling = true;
+  }
+
+
+  void SamplerStop( const std::string& i_strName )
+  {
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+      rumDebugContext* pcContext{ GetVMByName( i_strName ) };
+      if( pcContext && pcContext->m_bSampling )
+      {
+        // The hook is removed from Update() if nothing else needs it
+        StopSampling( *pcContext );
+      }
+    }
+
+    JoinStoppedSamplerThreads();
+  }
+
+
+  void SamplerThread( uint32_t i_uiGeneration )
+  {
+    using namespace std::chrono;
+
+    std::unique_lock<std::mutex> ulock( g_mtxSamplerLock );
+
+    auto tLastTick{ steady_clock::now() };
+    auto tNextTick{ tLastTick };
+
+    while( i_uiGeneration == g_uiSamplerGeneration )
+    {
+      const auto tNow{ steady_clock::now() };
+
+      // Each sample stands for the time since the previous tick, so a late tick weighs its samples accordingly
+      const int64_t iWeightNS{ duration_cast<nanoseconds>( tNow - tLastTick ).count() };
+      tLastTick = tNow;
+
+      for( rumDebugContext* pcContext : g_vSampledContexts )
+      {
+        pcContext->m_pcSampleBuffer->Drain( [pcContext, iWeightNS]( const rumDebugSample& i_rcSample )
+        {
+          AggregateSample( *pcContext, i_rcSample, iWeightNS );
+        } );
+
+        if( pcContext->m_bSampledCallTreeChanged &&
+            tNow - pcContext->m_tSampledCallTreeSnapshot >= milliseconds( PROFILER_PUBLISH_INTERVAL_MS ) )
+        {
+          PublishSampledCallTree( *pcContext );
+        }
+
+        // Ask for a sample on the next line the VM executes. A VM that isn't executing script won't answer, which
+        // leaves idle time out of the profile.
+        pcContext->m_bSampleRequested.store( true, std::memory_order_relaxed );
+      }
+
+      const nanoseconds tPeriod{ nanoseconds( seconds( 1 ) ) / g_uiSampleRateHz.load( std::memory_order_relaxed ) };
+      tNextTick += tPeriod;
+      if( tNextTick <= tNow )
+      {
+        // Fell behind, so skip the missed ticks rather than sampling in a burst
+        tNextTick = tNow + tPeriod;
+      }
+
+      g_cvSampler.wait_until( ulock, tNextTick, [i_uiGeneration]
+      {
+        return i_uiGeneration != g_uiSamplerGeneration;
+      } );
+    }
+  }
+
+
+  void SetHookTimingEnabled( bool i_bEnabled )
+  {
+    g_bTimeDebugHook.store( i_bEnabled, std::memory_order_relaxed );
+  }
+
+
+  void SetSampleRate( uint32_t i_uiRateHz )
+  {
+    g_uiSampleRateHz.store( std::clamp<uint32_t>( i_uiRateHz, SAMPLER_MIN_RATE_HZ, SAMPLER_MAX_RATE_HZ ),
+                            std::memory_order_relaxed );
+  }
+
+
+  void Shutdown()
+  {
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+      for( auto& iter : g_cDebugContexts )
+      {
+        if( iter.m_bSampling )
+        {
+          StopSampling( iter );
+        }
+
+        iter.m_bTracing = false;
+      }
+    }
+
+    JoinStoppedSamplerThreads();
+
+    // Finishes the trace and waits for queued exports to be written
+    rumDebugExport::Shutdown();
+  }
+
+
+  void StartTracing( rumDebugContext& io_rcContext )
+  {
+    if( !io_rcContext.m_pcTraceBuffer )
+    {
+      io_rcContext.m_pcTraceBuffer = std::make_unique<rumDebugTraceBuffer>();
+    }
+
+    rumDebugExport::TraceAddVM( io_rcContext );
+
+    io_rcContext.m_bTracing = true;
+  }
+
+
+  void StatsReset()
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+    g_cStatsBaseline = CollectStats();
+  }
+
+
+  void StopSampling( rumDebugContext& io_rcContext )
+  {
+    io_rcContext.m_bSampling = false;
+
+    {
+      std::lock_guard<std::mutex> cSamplerLockGuard( g_mtxSamplerLock );
+
+      const auto& iter{ std::find( g_vSampledContexts.begin(), g_vSampledContexts.end(), &io_rcContext ) };
+      if( iter != g_vSampledContexts.end() )
+      {
+        g_vSampledContexts.erase( iter );
+      }
+
+      io_rcContext.m_bSampleRequested.store( false, std::memory_order_relaxed );
+
+      // Keep the samples still waiting, at the nominal sample period
+      const int64_t iWeightNS{ 1000000000 / g_uiSampleRateHz.load( std::memory_order_relaxed ) };
+      io_rcContext.m_pcSampleBuffer->Drain( [&io_rcContext, iWeightNS]( const rumDebugSample& i_rcSample )
+      {
+        AggregateSample( io_rcContext, i_rcSample, iWeightNS );
+      } );
+
+      PublishSampledCallTree( io_rcContext );
+
+      if( g_vSampledContexts.empty() && g_cSamplerThread.joinable() )
+      {
+        // Joining here could stall the caller's access lock on the sampler's wakeup, so the thread is only moved out
+        ++g_uiSamplerGeneration;
+        g_vStoppedSamplerThreads.push_back( std::move( g_cSamplerThread ) );
+      }
+    }
+
+    g_cvSampler.notify_all();
+  }
+
+
   void SuspendVM( HSQUIRRELVM i_pcVM, rumDebugContext& i_rcContext, uint32_t i_uiLine,
                   const std::filesystem::path& i_fsFilePath )
   {
+    const auto tSuspended{ std::chrono::steady_clock::now() };
+
+    rumDebugHookStats::Add( i_rcContext.m_cHookStats.m_uiNumPauses, 1 );
+
+    i_rcContext.m_bInDebugHook = true;
+    i_rcContext.m_bPauseRequested = false;
+
     i_rcContext.m_vCallstack.clear();
 
     i_rcContext.m_bFocusOnCurrentInstruction = true;
@@ -765,28 +2939,73 @@ namespace rumDebugVM
                                             std::string( cStackInfos.funcname ) } );
     }
 
-    auto iter{ std::find( g_cDebugContexts.begin(), g_cDebugContexts.end(), i_pcVM ) };
-    if( iter != g_cDebugContexts.end() )
+    g_pcCurrentDebugContext = &i_rcContext;
+
+    g_uiLocalVariableStackLevel = 0;
+
     {
-      g_pcCurrentDebugContext = &*iter;
+      std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+      // Changes are flagged against the last pause, so the flags from that pause no longer apply
+      for( auto& iter : g_cWatchVariables )
+      {
+        iter.m_bChanged = false;
+      }
+
+      // The top frame's locals are only compared while execution is still in the same call
+      std::string strTopFrame;
+      if( !i_rcContext.m_vCallstack.empty() )
+      {
+        const auto& rcTopFrame{ i_rcContext.m_vCallstack.front() };
+        strTopFrame = rcTopFrame.m_strFilename + '\n' + rcTopFrame.m_strFunction + '\n' +
+                      std::to_string( i_rcContext.m_vCallstack.size() );
+      }
+
+      if( strTopFrame == g_strTopFrame )
+      {
+        std::swap( g_vPreviousTopFrameLocals, g_vTopFrameLocals );
+      }
+      else
+      {
+        g_vPreviousTopFrameLocals.clear();
+        g_strTopFrame = std::move( strTopFrame );
+      }
     }
 
-    g_uiLocalVariableStackLevel = 0;
+    // Script may have changed the root and const tables since the last pause
+    rumDebugUtility::AdvanceObjectNameEpoch();
+
+    i_rcContext.m_bUpdateVariables = true;
 
     do
     {
       {
+        std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+        // Each update gets its own formatting budget, so one slow description can't stall the paused VM for long
+        rumDebugUtility::StartFormatBudget( FORMAT_TIME_BUDGET_MS );
+
+        if( i_rcContext.m_bUpdateVariables )
+        {
 #if DEBUG_OUTPUT
-        std::cout << "Parsing variables\n";
+          std::cout << "Parsing variables\n";
 #endif
 
-        std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+          // Only containers' summaries are built here. Their children are built when expanded by the interface.
+          g_mapVariableChildren.clear();
+          g_mapVariableDescriptions.clear();
+
+          BuildLocalVariables( i_pcVM, g_uiLocalVariableStackLevel );
+          BuildVariables( i_pcVM, g_cWatchVariables, &i_rcContext );
 
-        BuildLocalVariables( i_pcVM, g_uiLocalVariableStackLevel );
-        BuildVariables( i_pcVM, g_cWatchVariables );
-        BuildVariables( i_pcVM, g_cRequestedVariables );
+          // Requested variables are only ever looked up, since evaluating them could have side effects
+          BuildVariables( i_pcVM, g_cRequestedVariables, nullptr );
 
-        i_rcContext.m_bUpdateVariables = false;
+          i_rcContext.m_bUpdateVariables = false;
+        }
+
+        FetchRequestedVariables( i_pcVM );
+        i_rcContext.m_bFetchVariables = false;
       }
 
       i_rcContext.m_bPaused = true;
@@ -795,11 +3014,77 @@ namespace rumDebugVM
       s_cvDebugLock.wait( ulock );
 
       i_rcContext.m_bPaused = false;
-    } while( i_rcContext.m_bUpdateVariables );
+    } while( i_rcContext.m_bUpdateVariables || i_rcContext.m_bFetchVariables );
+
+    {
+      std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+      ReleaseVariableHandles( i_pcVM );
+    }
+
+    // Time spent suspended isn't counted against the calls that were executing
+    const auto tSuspendedDuration{ std::chrono::steady_clock::now() - tSuspended };
+    for( auto& iter : i_rcContext.m_vProfileStack )
+    {
+      iter.m_tStart += tSuspendedDuration;
+    }
+
+    const int64_t iSuspendedNS{ std::chrono::duration_cast<std::chrono::nanoseconds>( tSuspendedDuration ).count() };
+    rumDebugHookStats::Add( i_rcContext.m_cHookStats.m_uiPausedNS, static_cast<uint64_t>( iSuspendedNS ) );
+
+    if( i_rcContext.m_bTracing )
+    {
+      i_rcContext.m_pcTraceBuffer->Push( { rumDebugTraceEvent::ToTimeNS( tSuspended ), iSuspendedNS, 0, 0, 0,
+                                           rumDebugTraceEvent::Type::Pause } );
+    }
+
+    for( auto& iter : g_cRequestedVariables )
+    {
+      if( iter.m_pcAccessPath )
+      {
+        rumDebugUtility::ReleaseAccessPath( i_pcVM, *iter.m_pcAccessPath );
+      }
+    }
 
     g_cRequestedVariables.clear();
 
     Update();
+
+    i_rcContext.m_bInDebugHook = false;
+  }
+
+
+  bool TraceStart( const std::filesystem::path& i_fsFilePath )
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    if( !rumDebugExport::TraceStart( i_fsFilePath ) )
+    {
+      return false;
+    }
+
+    for( auto& iter : g_cDebugContexts )
+    {
+      if( iter.m_bAttached )
+      {
+        StartTracing( iter );
+      }
+    }
+
+    return true;
+  }
+
+
+  void TraceStop()
+  {
+    std::lock_guard<std::mutex> cLockGuard( g_mtxAccessLock );
+
+    // The hook is removed from Update() if nothing else needs it
+    for( auto& iter : g_cDebugContexts )
+    {
+      iter.m_bTracing = false;
+    }
+
+    rumDebugExport::TraceStop();
   }
 
 
@@ -820,6 +3105,97 @@ namespace rumDebugVM
       DetachVM( g_strDetachRequest );
       g_strDetachRequest.clear();
     }
+
+    // Sampler threads stopped by detaching, here or by the host, are joined outside of the access lock
+    JoinStoppedSamplerThreads();
+
+    // Install the debug hook on VMs that have something for it to check, and remove it from VMs that no longer do. This
+    // can't be done from the threads that request the changes, since the VM may be executing at the time and Squirrel
+    // reads the hook without any synchronization.
+    for( auto& iter : g_cDebugContexts )
+    {
+      UpdateCallTree( iter );
+
+      ArmDebugHook( iter );
+
+      if( iter.m_bHookInstalled && !iter.m_bInDebugHook && !WantsDebugHook( iter ) )
+      {
+        sq_setnativedebughook( iter.m_pcVM, NULL );
+        iter.m_bHookInstalled = false;
+      }
+    }
+
+    rumDebugExport::Update();
+  }
+
+
+  void UpdateCallTree( rumDebugContext& io_rcContext )
+  {
+    auto& rvStack{ io_rcContext.m_vProfileStack };
+
+    if( io_rcContext.m_bCallTreeResetRequested )
+    {
+      io_rcContext.m_bCallTreeResetRequested = false;
+
+      auto& rcCallTree{ io_rcContext.m_cCallTree };
+
+      std::vector<uint32_t> vExecutingFunctions;
+      vExecutingFunctions.reserve( rvStack.size() );
+      for( const auto& iter : rvStack )
+      {
+        vExecutingFunctions.push_back( rcCallTree.m_vNodes[iter.m_uiNode].m_uiFunction );
+      }
+
+      rcCallTree.ClearNodes();
+      io_rcContext.m_mapCallTreeNodes.clear();
+
+      // Calls that are still executing are timed from now on, through a new path
+      const auto tNow{ std::chrono::steady_clock::now() };
+      uint32_t uiParent{ 0 };
+      for( size_t i{ 0 }; i < rvStack.size(); ++i )
+      {
+        const uint32_t uiNode{ FindOrAddCallTreeNode( rcCallTree, io_rcContext.m_mapCallTreeNodes, uiParent,
+                                                      vExecutingFunctions[i] ) };
+
+        rvStack[i].m_uiNode = uiNode;
+        rvStack[i].m_tStart = tNow;
+        rvStack[i].m_iChildNS = 0;
+
+        uiParent = uiNode;
+      }
+
+      io_rcContext.m_bCallTreeChanged = true;
+    }
+
+    if( io_rcContext.m_bCallTreeChanged &&
+        ( !io_rcContext.m_bFunctionProfiling ||
+          std::chrono::steady_clock::now() - io_rcContext.m_tCallTreeSnapshot >=
+            std::chrono::milliseconds( PROFILER_PUBLISH_INTERVAL_MS ) ) )
+    {
+      PublishCallTree( io_rcContext );
+    }
+
+    if( !io_rcContext.m_bFunctionProfiling )
+    {
+      // Calls still executing when profiling stopped won't be timed
+      rvStack.clear();
+    }
+  }
+
+
+  bool WantsDebugHook( const rumDebugContext& i_rcContext )
+  {
+    if( !i_rcContext.m_bAttached )
+    {
+      return false;
+    }
+
+    const auto pcBreakpointIndex{ std::atomic_load_explicit( &g_pcBreakpointIndex, std::memory_order_acquire ) };
+
+    return !pcBreakpointIndex->IsEmpty() || pcBreakpointIndex->HasFunctionBreakpoints() ||
+           i_rcContext.m_bPauseRequested || i_rcContext.m_bLineProfiling || i_rcContext.m_bLineCoverage ||
+           i_rcContext.m_bFunctionProfiling || i_rcContext.m_bSampling || i_rcContext.m_bTracing ||
+           ( i_rcContext.m_eStepDirective != rumDebugContext::StepDirective::Resume );
   }
 
 
@@ -857,9 +3233,15 @@ namespace rumDebugVM
     auto iter{ std::find( g_cWatchVariables.begin(), g_cWatchVariables.end(), i_rcVariable ) };
     if( iter != g_cWatchVariables.end() )
     {
+      EvictWatchExpression( iter->m_strName );
+      EvictAccessPath( std::move( iter->m_pcAccessPath ) );
+
       iter->m_strName = i_strName;
       iter->m_strValue.clear();
       iter->m_strType.clear();
+      iter->m_cFingerprint = rumDebugValueFingerprint();
+      iter->m_bChanged = false;
+      iter->m_pcAccessPath.reset();
 
       if( g_pcCurrentDebugContext )
       {
@@ -885,6 +3267,8 @@ namespace rumDebugVM
     if( iter != g_cWatchVariables.end() )
     {
       // Remove the variable
+      EvictWatchExpression( iter->m_strName );
+      EvictAccessPath( std::move( iter->m_pcAccessPath ) );
       g_cWatchVariables.erase( iter );
       rumDebugInterface::RequestSettingsUpdate();
     }
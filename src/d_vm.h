@@ -8,9 +8,17 @@
 #include <squirrel.h>
 
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 
+// The event types Squirrel passes to a native debug hook
+#define SQ_LINEEXECUTION  'l'
+#define SQ_FUNCTIONCALL   'c'
+#define SQ_FUNCTIONRETURN 'r'
+
 // The VM Manager for the Squirrel ImGui Debugger. This interface tracks attached VM Contexts, breakpoints, open
 // files, and various variable groups. Code for this class is executed on the main thread and handles all Squirrel data
 // access via requests from the Squirrel ImGui Interface, such as variables and callstack info.
@@ -22,31 +30,118 @@ namespace rumDebugVM
 
   void BreakpointAdd( rumDebugBreakpoint i_cBreakpoint );
   void BreakpointRemove( const rumDebugBreakpoint& i_rcBreakpoint );
+  void BreakpointSetCondition( const rumDebugBreakpoint& i_rcBreakpoint, const std::string& i_strCondition );
+  void BreakpointSetLogMessage( const rumDebugBreakpoint& i_rcBreakpoint, const std::string& i_strLogMessage );
   void BreakpointToggle( const rumDebugBreakpoint& i_rcBreakpoint );
 
+  // Marks the lines the named VM executes as covered until stopped, without pausing the VM. Covered lines are kept
+  // when stopped and only cleared by a reset.
+  void CoverageReset( const std::string& i_strName );
+  void CoverageStart( const std::string& i_strName );
+  void CoverageStop( const std::string& i_strName );
+
+  // Passes each logpoint message logged since the last drain to the callback, oldest first. Logpoint messages must
+  // only be drained from a single thread.
+  void DrainLogMessages( const std::function<void( const char*, size_t )>& i_rfnCallback );
+
   void EnableDebugInfo( HSQUIRRELVM i_pcVM, bool i_bEnable = true );
 
+  // Writes the named VM's most recently published call tree to the file in collapsed stack format from the export
+  // writer thread. Returns false if there is no call tree to write. Write errors are reported by GetLastExportError.
+  bool ExportCollapsedStacks( const std::string& i_strName, rumDebugProfileSource i_eSource,
+                              const std::filesystem::path& i_fsFilePath );
+
+  // Writes the lines covered by every VM to the file in lcov tracefile format from the export writer thread. Returns
+  // false if no lines are covered.
+  bool ExportLineCoverage( const std::filesystem::path& i_fsFilePath );
+
   void FileOpen( const std::filesystem::path& i_fsFilePath, uint32_t i_uiLine );
   void FileClose( const std::filesystem::path& i_fsFilePath );
 
+  void FunctionBreakpointAdd( rumDebugFunctionBreakpoint i_cBreakpoint );
+  void FunctionBreakpointRemove( const rumDebugFunctionBreakpoint& i_rcBreakpoint );
+  void FunctionBreakpointResetHits( const rumDebugFunctionBreakpoint& i_rcBreakpoint );
+  void FunctionBreakpointSetHitCount( const rumDebugFunctionBreakpoint& i_rcBreakpoint, uint32_t i_uiHitCount );
+  void FunctionBreakpointToggle( const rumDebugFunctionBreakpoint& i_rcBreakpoint );
+
+  // Times calls on the named VM until stopped. Timings are published for display a few times per second and are kept
+  // when stopped until reset.
+  void FunctionProfilerReset( const std::string& i_strName );
+  void FunctionProfilerStart( const std::string& i_strName );
+  void FunctionProfilerStop( const std::string& i_strName );
+
   const std::vector<rumDebugBreakpoint> GetBreakpointsCopy();
   const std::vector<rumDebugBreakpoint>& GetBreakpointsRef();
 
+  // The named VM's most recently published function profiler or sampler call tree, or null if it has never been
+  // profiled that way
+  std::shared_ptr<const rumDebugCallTree> GetCallTree( const std::string& i_strName, rumDebugProfileSource i_eSource );
+
   const rumDebugContext* GetCurrentDebugContext();
-  const std::vector<rumDebugContext>& GetDebugContexts();
+  const std::deque<rumDebugContext>& GetDebugContexts();
+
+  const std::vector<rumDebugFunctionBreakpoint> GetFunctionBreakpointsCopy();
+  const std::vector<rumDebugFunctionBreakpoint>& GetFunctionBreakpointsRef();
+
+  // Sums every VM's executed or sampled line counts for the file into the vector, indexed by line, and returns the
+  // highest count
+  uint32_t GetLineCounts( const std::filesystem::path& i_fsFilePath, rumDebugProfileSource i_eSource,
+                          std::vector<uint32_t>& o_vCounts );
+
+  // The most recent error from writing a trace or export, or empty if there has been none
+  std::string GetLastExportError();
+
+  // ORs every VM's covered lines for the file into the bitset, indexed by line. Returns false if no lines of the file
+  // are covered.
+  bool GetLineCoverage( const std::filesystem::path& i_fsFilePath, std::vector<uint64_t>& o_vLines );
 
   const std::vector<rumDebugVariable>& GetLocalVariablesRef();
 
+  // The number of logpoint messages dropped because the interface hadn't drained them fast enough
+  uint64_t GetNumDroppedLogMessages();
+
+  // The number of samples the named VM dropped because the sampler thread hadn't aggregated them fast enough
+  uint64_t GetNumDroppedSamples( const std::string& i_strName );
+
+  // The number of trace events dropped because the export writer hadn't collected them fast enough
+  uint64_t GetNumDroppedTraceEvents();
+
+  // The number of children of the variable with the handle, fetched the same way as GetVariableChildren
+  bool GetNumVariableChildren( uint32_t i_uiHandle, uint32_t& o_uiNumChildren );
+
   const std::map<std::string, rumDebugFile> GetOpenedFilesCopy();
   const std::map<std::string, rumDebugFile>& GetOpenedFilesRef();
 
   const std::vector<rumDebugVariable>& GetRequestedVariablesRef();
 
+  // The sampler's rate in samples per second
+  uint32_t GetSampleRate();
+
+  // The debugger's own overhead since the stats were last reset, summed over every VM
+  rumDebugStats GetStats();
+
+  // Copies a page of the children of the variable with the handle, or its full description. Returns false if they
+  // haven't been fetched yet, in which case they are requested from the paused VM and can be asked for again on a
+  // later frame. Pages hold VARIABLE_PAGE_SIZE children.
+  bool GetVariableChildren( uint32_t i_uiHandle, uint32_t i_uiPage, std::vector<rumDebugVariable>& o_vChildren );
+  bool GetVariableDescription( uint32_t i_uiHandle, std::string& o_strDescription );
+
   const std::vector<rumDebugVariable> GetWatchedVariablesCopy();
   const std::vector<rumDebugVariable>& GetWatchedVariablesRef();
 
   SQInteger IsDebuggerAttached( HSQUIRRELVM i_pcVM );
 
+  // Whether time spent in the debug hook is measured. Timing adds two clock reads to every hook event, so it is off
+  // by default.
+  bool IsHookTimingEnabled();
+
+  bool IsTracing();
+
+  // Counts executed lines on the named VM until stopped. Counts are kept when stopped and only cleared by a reset.
+  void LineProfilerReset( const std::string& i_strName );
+  void LineProfilerStart( const std::string& i_strName );
+  void LineProfilerStop( const std::string& i_strName );
+
   void RegisterVM( HSQUIRRELVM i_pcVM, const std::string& i_strName );
 
   void RequestAttachVM( const std::string& i_strName );
@@ -54,6 +149,8 @@ namespace rumDebugVM
 
   void RequestChangeStackLevel( uint32_t i_uiStackLevel );
 
+  void RequestPauseVM( const std::string& i_strName );
+
   void RequestResume();
   void RequestStepInto();
   void RequestStepOut();
@@ -62,6 +159,29 @@ namespace rumDebugVM
   void RequestVariable( const rumDebugVariable& i_rcVariable );
   void RequestVariableUpdates();
 
+  // Samples the named VM's current line and call stack at the sample rate until stopped, from a background thread that
+  // runs while any VM is sampled. Samples are kept when stopped until reset.
+  void SamplerReset( const std::string& i_strName );
+  void SamplerStart( const std::string& i_strName );
+  void SamplerStop( const std::string& i_strName );
+
+  void SetHookTimingEnabled( bool i_bEnabled );
+
+  // Sets the sampler's rate in samples per second, clamped to SAMPLER_MIN_RATE_HZ and SAMPLER_MAX_RATE_HZ
+  void SetSampleRate( uint32_t i_uiRateHz );
+
+  // Stops the sampler and any trace, and waits for exports to finish writing. Call before destroying attached VMs.
+  void Shutdown();
+
+  // Starts counting the stats returned by GetStats from zero
+  void StatsReset();
+
+  // Records calls, returns, samples, and pauses of every attached VM to the file as Chrome trace event JSON until
+  // stopped. Events are written by the export writer thread as they are recorded. Returns false if a trace is already
+  // recording or the file can't be opened.
+  bool TraceStart( const std::filesystem::path& i_fsFilePath );
+  void TraceStop();
+
   void Update();
 
   bool WatchVariableAdd( const std::string& i_strName );
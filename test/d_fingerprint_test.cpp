@@ -0,0 +1,140 @@
+/*
+
+Squirrel ImGui Debugger Fingerprint Test
+
+MIT License
+
+Copyright 2022 Jonathon Blake Wood-Brooks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Checks that value fingerprints tell apart the values the Locals and Watched tabs must show as changed. Failures are
+// written to stderr and the program exits with a non-zero status.
+
+#include <d_utility.h>
+
+#include <squirrel.h>
+
+#include <cstdio>
+#include <string>
+
+
+namespace
+{
+  uint32_t g_uiNumFailures{ 0 };
+
+
+  void Check( bool i_bCondition, const char* i_strDescription )
+  {
+    if( !i_bCondition )
+    {
+      fprintf( stderr, "FAILED: %s\n", i_strDescription );
+      ++g_uiNumFailures;
+    }
+  }
+
+
+  rumDebugValueFingerprint FingerprintString( HSQUIRRELVM i_pcVM, const std::string& i_strValue )
+  {
+    sq_pushstring( i_pcVM, i_strValue.c_str(), static_cast<SQInteger>( i_strValue.size() ) );
+    const rumDebugValueFingerprint cFingerprint{ rumDebugUtility::ComputeValueFingerprint( i_pcVM, -1, false ) };
+    sq_poptop( i_pcVM );
+
+    return cFingerprint;
+  }
+} // namespace
+
+
+int main()
+{
+  HSQUIRRELVM pcVM{ sq_open( 1024 ) };
+
+  // Squirrel's string hash only reads about the first 32 characters of long strings, so these differ only in
+  // characters that it never reads
+  const std::string strLong( 4096, 'a' );
+  std::string strLongTail{ strLong };
+  strLongTail.back() = 'b';
+
+  Check( !FingerprintString( pcVM, strLong ).IsSameValue( FingerprintString( pcVM, strLongTail ) ),
+         "Long strings of the same length that differ only in the tail have different fingerprints" );
+
+  std::string strLongMiddle{ strLong };
+  strLongMiddle[strLong.size() / 2 + 1] = 'b';
+
+  Check( !FingerprintString( pcVM, strLong ).IsSameValue( FingerprintString( pcVM, strLongMiddle ) ),
+         "Long strings of the same length that differ only in the middle have different fingerprints" );
+
+  Check( FingerprintString( pcVM, strLong ).IsSameValue( FingerprintString( pcVM, std::string( 4096, 'a' ) ) ),
+         "Equal long strings have the same fingerprint" );
+
+  Check( !FingerprintString( pcVM, "ab" ).IsSameValue( FingerprintString( pcVM, "ba" ) ),
+         "Short strings with the same characters in a different order have different fingerprints" );
+
+  sq_pushinteger( pcVM, 1 );
+  const rumDebugValueFingerprint cInteger{ rumDebugUtility::ComputeValueFingerprint( pcVM, -1, false ) };
+  const rumDebugValueFingerprint cHexInteger{ rumDebugUtility::ComputeValueFingerprint( pcVM, -1, true ) };
+  sq_poptop( pcVM );
+
+  sq_pushfloat( pcVM, 1.0f );
+  const rumDebugValueFingerprint cFloat{ rumDebugUtility::ComputeValueFingerprint( pcVM, -1, false ) };
+  sq_poptop( pcVM );
+
+  Check( !cInteger.IsSameValue( cFloat ), "An integer and a float of the same value have different fingerprints" );
+  Check( cInteger.IsSameValue( cHexInteger ) && cInteger != cHexInteger,
+         "The same integer formatted as hex is the same value but must be formatted again" );
+
+  // Containers are changed in place, which keeps their identity and size
+  sq_newtable( pcVM );
+  sq_pushstring( pcVM, "x", -1 );
+  sq_pushinteger( pcVM, 1 );
+  sq_newslot( pcVM, -3, SQFalse );
+  const rumDebugValueFingerprint cTable{ rumDebugUtility::ComputeValueFingerprint( pcVM, -1, false ) };
+
+  sq_pushstring( pcVM, "x", -1 );
+  sq_pushinteger( pcVM, 5 );
+  sq_set( pcVM, -3 );
+
+  Check( !cTable.IsSameValue( rumDebugUtility::ComputeValueFingerprint( pcVM, -1, false ) ),
+         "A table with a member changed in place has a different fingerprint" );
+  sq_poptop( pcVM );
+
+  sq_newarray( pcVM, 0 );
+  sq_pushinteger( pcVM, 0 );
+  sq_arrayappend( pcVM, -2 );
+  const rumDebugValueFingerprint cArray{ rumDebugUtility::ComputeValueFingerprint( pcVM, -1, false ) };
+
+  sq_pushinteger( pcVM, 0 );
+  sq_pushinteger( pcVM, 1 );
+  sq_set( pcVM, -3 );
+
+  Check( !cArray.IsSameValue( rumDebugUtility::ComputeValueFingerprint( pcVM, -1, false ) ),
+         "An array with an element changed in place has a different fingerprint" );
+  sq_poptop( pcVM );
+
+  sq_close( pcVM );
+
+  if( 0 == g_uiNumFailures )
+  {
+    printf( "All fingerprint checks passed\n" );
+  }
+
+  return g_uiNumFailures == 0 ? 0 : 1;
+}